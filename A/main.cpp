@@ -1,8 +1,15 @@
-#include <iostream>
 #include <string>
 #include <vector>
 
+#include "../benchmark/counters.h"
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
 std::vector<uint32_t> PrefixFunction(const std::string& str) {
+    COUNTER_ADD("prefix_function.symbols", str.size());
     std::vector<uint32_t> prefix(str.length(), 0);
     for (uint32_t position = 1; position < str.length(); ++position) {
         uint32_t current_len = prefix[position - 1];
@@ -10,6 +17,7 @@ std::vector<uint32_t> PrefixFunction(const std::string& str) {
             if (str[current_len] == str[position]) {
                 break;
             }
+            COUNTER_INCREMENT("prefix_function.failure_steps");
             current_len = prefix[current_len - 1];
         }
         if (str[position] == str[current_len]) {
@@ -20,14 +28,30 @@ std::vector<uint32_t> PrefixFunction(const std::string& str) {
     return prefix;
 }
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "prefix_function", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, [](std::string str) { return str; },
+        [](const std::string& str) -> uint64_t { return PrefixFunction(str).back(); });
+    return 0;
+}
+#endif
+
 int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     std::string str;
-    std::cin >> str;
+    input >> str;
 
     auto prefix = PrefixFunction(str);
     for (auto& elem : prefix) {
-        std::cout << elem << ' ';
+        output << elem << ' ';
     }
-    std::cout << std::endl;
+    output << '\n';
     return 0;
 }
@@ -1,8 +1,34 @@
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#include "../benchmark/counters.h"
+#include "../io/fast_io.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STRINGS_X86_SIMD
+#endif
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+const uint32_t kByteAlphabetSize = 256;
+const size_t kShardsPerThread = 8;
+const size_t kMinShardSize = 1 << 16;
+// The automaton table of a pattern this long takes (255 + 1) * 256 16-bit states, 128 KiB. Building
+// the table only pays off when the text is much longer than the table.
+const size_t kMaxAutomatonPatternLength = 255;
+const size_t kMinTextLengthPerAutomatonCell = 64;
+
 std::vector<uint32_t> PrefixFunction(const std::string& str) {
+    COUNTER_ADD("prefix_function.symbols", str.size());
     std::vector<uint32_t> prefix(str.length(), 0);
     for (uint32_t position = 1; position < str.length(); ++position) {
         uint32_t current_len = prefix[position - 1];
@@ -10,6 +36,7 @@ std::vector<uint32_t> PrefixFunction(const std::string& str) {
             if (str[current_len] == str[position]) {
                 break;
             }
+            COUNTER_INCREMENT("prefix_function.failure_steps");
             current_len = prefix[current_len - 1];
         }
         if (str[position] == str[current_len]) {
@@ -20,29 +47,382 @@ std::vector<uint32_t> PrefixFunction(const std::string& str) {
     return prefix;
 }
 
-std::vector<uint32_t> FindEntryOfStringInText(const std::string& text, const std::string& str) {
-    std::vector<uint32_t> number_of_entry;
-    char separator = '0';
-    std::string str_to_find = str + separator + text;
-    auto prefix = PrefixFunction(str_to_find);
-    for (uint32_t iteration = 0; iteration < prefix.size(); ++iteration) {
-        if (prefix[iteration] == str.length() && iteration >= 2 * str.length()) {
-            number_of_entry.push_back(iteration - 2 * str.length());
+// Candidate search: returns the first position in [begin, limit) where text[position] == first and
+// text[position + last_offset] == last, or limit when there is none.
+using FindCandidateT = size_t (*)(const char*, size_t, size_t, char, char, size_t);
+
+size_t FindCandidateScalar(const char* text, size_t begin, size_t limit, char first, char last, size_t last_offset) {
+    while (begin < limit) {
+        const void* found = std::memchr(text + begin, first, limit - begin);
+        if (found == nullptr) {
+            return limit;
+        }
+        begin = static_cast<const char*>(found) - text;
+        if (text[begin + last_offset] == last) {
+            return begin;
+        }
+        ++begin;
+    }
+    return limit;
+}
+
+#ifdef STRINGS_X86_SIMD
+__attribute__((target("sse2"))) size_t FindCandidateSse2(const char* text, size_t begin, size_t limit, char first,
+                                                         char last, size_t last_offset) {
+    const __m128i first_block = _mm_set1_epi8(first);
+    const __m128i last_block = _mm_set1_epi8(last);
+    for (; begin + 16 <= limit; begin += 16) {
+        __m128i block_begin = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + begin));
+        __m128i block_end = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + begin + last_offset));
+        __m128i equal = _mm_and_si128(_mm_cmpeq_epi8(block_begin, first_block), _mm_cmpeq_epi8(block_end, last_block));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(equal));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+    return FindCandidateScalar(text, begin, limit, first, last, last_offset);
+}
+
+__attribute__((target("avx2"))) size_t FindCandidateAvx2(const char* text, size_t begin, size_t limit, char first,
+                                                         char last, size_t last_offset) {
+    const __m256i first_block = _mm256_set1_epi8(first);
+    const __m256i last_block = _mm256_set1_epi8(last);
+    for (; begin + 32 <= limit; begin += 32) {
+        __m256i block_begin = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + begin));
+        __m256i block_end = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + begin + last_offset));
+        __m256i equal =
+            _mm256_and_si256(_mm256_cmpeq_epi8(block_begin, first_block), _mm256_cmpeq_epi8(block_end, last_block));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(equal));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+    return FindCandidateSse2(text, begin, limit, first, last, last_offset);
+}
+#endif
+
+FindCandidateT SelectFindCandidate() {
+#ifdef STRINGS_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        return FindCandidateAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return FindCandidateSse2;
+    }
+#endif
+    return FindCandidateScalar;
+}
+
+const FindCandidateT kFindCandidate = SelectFindCandidate();
+
+// Runs the text through the prefix function of the pattern only, so the text can arrive in chunks
+// and never has to be glued to the pattern.
+class PrefixFunctionMatcher {
+private:
+    std::string str_;
+    std::vector<uint32_t> prefix_;
+
+    uint32_t current_len_ = 0;
+    uint64_t position_ = 0;
+
+    FindCandidateT find_candidate_ = nullptr;
+
+public:
+    // While no match is in progress the text is skipped with find_candidate, and the prefix function
+    // only runs from positions whose first and last symbols agree with the pattern. nullptr turns
+    // the skipping off.
+    explicit PrefixFunctionMatcher(const std::string& str, FindCandidateT find_candidate = kFindCandidate) {
+        str_ = str;
+        prefix_ = PrefixFunction(str);
+        find_candidate_ = find_candidate;
+    }
+
+    uint32_t Step(const char& symbol) {
+        while (current_len_ > 0) {
+            if (current_len_ < str_.length() && str_[current_len_] == symbol) {
+                break;
+            }
+            current_len_ = prefix_[current_len_ - 1];
+        }
+        if (current_len_ < str_.length() && str_[current_len_] == symbol) {
+            ++current_len_;
+        }
+        ++position_;
+        return current_len_;
+    }
+
+    template <class Callback>
+    void Feed(const char* chunk, const size_t& size, Callback callback) {
+        if (str_.empty()) {
+            return;
+        }
+        size_t last_offset = str_.length() - 1;
+        size_t limit = size > last_offset ? size - last_offset : 0;
+        for (size_t iteration = 0; iteration < size; ++iteration) {
+            if (current_len_ == 0 && find_candidate_ != nullptr && iteration < limit) {
+                auto candidate = find_candidate_(chunk, iteration, limit, str_.front(), str_.back(), last_offset);
+                position_ += candidate - iteration;
+                iteration = candidate;
+                if (iteration == size) {
+                    break;
+                }
+            }
+            if (Step(chunk[iteration]) == str_.length()) {
+                callback(position_ - str_.length());
+            }
+        }
+    }
+};
+
+// Prefix function compiled into a full [state][byte] transition table: every text byte costs one
+// table load and the failure-link loop disappears from the scan.
+template <class StateT>
+class PrefixFunctionAutomaton {
+private:
+    std::vector<StateT> transitions_;
+
+    StateT length_ = 0;
+    StateT state_ = 0;
+    uint64_t position_ = 0;
+
+    char first_ = 0;
+    char last_ = 0;
+    FindCandidateT find_candidate_ = nullptr;
+
+public:
+    // Skips the text in the start state the same way PrefixFunctionMatcher does; nullptr turns the
+    // skipping off.
+    explicit PrefixFunctionAutomaton(const std::string& str, FindCandidateT find_candidate = kFindCandidate) {
+        length_ = static_cast<StateT>(str.length());
+        if (!str.empty()) {
+            first_ = str.front();
+            last_ = str.back();
+        }
+        find_candidate_ = find_candidate;
+        transitions_.resize((str.length() + 1) * kByteAlphabetSize, 0);
+
+        auto prefix = PrefixFunction(str);
+        for (size_t state = 0; state <= str.length(); ++state) {
+            for (uint32_t symbol = 0; symbol < kByteAlphabetSize; ++symbol) {
+                auto& transition = transitions_[state * kByteAlphabetSize + symbol];
+                if (state < str.length() && static_cast<unsigned char>(str[state]) == symbol) {
+                    transition = static_cast<StateT>(state + 1);
+                } else if (state > 0) {
+                    transition = transitions_[prefix[state - 1] * kByteAlphabetSize + symbol];
+                }
+            }
+        }
+    }
+
+    template <class Callback>
+    void Feed(const char* chunk, const size_t& size, Callback callback) {
+        if (length_ == 0) {
+            return;
+        }
+        const StateT* transitions = transitions_.data();
+        StateT state = state_;
+        size_t last_offset = length_ - 1;
+        size_t limit = size > last_offset ? size - last_offset : 0;
+        for (size_t iteration = 0; iteration < size; ++iteration) {
+            if (state == 0 && find_candidate_ != nullptr && iteration < limit) {
+                iteration = find_candidate_(chunk, iteration, limit, first_, last_, last_offset);
+                if (iteration == size) {
+                    break;
+                }
+            }
+            auto symbol = static_cast<unsigned char>(chunk[iteration]);
+            state = transitions[static_cast<size_t>(state) * kByteAlphabetSize + symbol];
+            if (state == length_) {
+                callback(position_ + iteration + 1 - length_);
+            }
+        }
+        state_ = state;
+        position_ += size;
+    }
+};
+
+// Calls callback(entry) for every entry of str in text, in increasing order, without collecting them.
+// Short patterns in long texts run through the automaton, whose 16-bit table stays small enough for the
+// cache; everything else through the prefix function, which needs no table at all.
+template <class Callback>
+void ForEachEntryOfStringInText(std::string_view text, const std::string& str, Callback callback) {
+    size_t automaton_cell_count = (str.length() + 1) * kByteAlphabetSize;
+    if (str.length() <= kMaxAutomatonPatternLength &&
+        text.length() >= automaton_cell_count * kMinTextLengthPerAutomatonCell) {
+        PrefixFunctionAutomaton<uint16_t> automaton(str);
+        automaton.Feed(text.data(), text.length(), callback);
+        return;
+    }
+    PrefixFunctionMatcher matcher(str);
+    matcher.Feed(text.data(), text.length(), callback);
+}
+
+std::vector<uint64_t> FindEntryOfStringInText(const std::string& text, const std::string& str) {
+    std::vector<uint64_t> number_of_entry;
+    ForEachEntryOfStringInText(text, str,
+                               [&number_of_entry](const uint64_t& entry) { number_of_entry.push_back(entry); });
+    return number_of_entry;
+}
+
+// Shards overlap by |str| - 1 symbols so that no entry is cut in half, and every shard reports only
+// the entries that start inside its own range: concatenating the shards in order gives a sorted list
+// without duplicates. Threads take the next shard from a shared counter, so a few dense shards do not
+// hold up the rest. thread_count == 0 means one thread per hardware core.
+std::vector<uint64_t> FindEntryOfStringInTextParallel(const std::string& text, const std::string& str,
+                                                      uint32_t thread_count = 0) {
+    if (thread_count == 0) {
+        thread_count = std::max(1U, std::thread::hardware_concurrency());
+    }
+    if (str.empty() || text.length() < str.length()) {
+        return {};
+    }
+
+    size_t shard_count = static_cast<size_t>(thread_count) * kShardsPerThread;
+    size_t shard_size = std::max(kMinShardSize, (text.length() + shard_count - 1) / shard_count);
+    shard_count = (text.length() + shard_size - 1) / shard_size;
+    thread_count = static_cast<uint32_t>(std::min<size_t>(thread_count, shard_count));
+
+    std::vector<std::vector<uint64_t>> number_of_entry_in_shard(shard_count);
+    std::atomic<size_t> next_shard(0);
+    const PrefixFunctionMatcher prototype(str);
+
+    auto worker = [&]() {
+        for (size_t shard = next_shard++; shard < shard_count; shard = next_shard++) {
+            size_t begin = shard * shard_size;
+            size_t end = std::min(text.length(), begin + shard_size);
+            size_t overlap_end = std::min(text.length(), end + str.length() - 1);
+
+            auto& number_of_entry = number_of_entry_in_shard[shard];
+            auto matcher = prototype;
+            matcher.Feed(text.data() + begin, overlap_end - begin, [&](const uint64_t& entry) {
+                if (begin + entry < end) {
+                    number_of_entry.push_back(begin + entry);
+                }
+            });
         }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t iteration = 1; iteration < thread_count; ++iteration) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<uint64_t> number_of_entry;
+    for (auto& shard_entries : number_of_entry_in_shard) {
+        number_of_entry.insert(number_of_entry.end(), shard_entries.begin(), shard_entries.end());
     }
     return number_of_entry;
 }
 
+#ifdef BENCHMARK
+template <class Matcher>
+void BenchmarkMatcher(const std::string& name, const std::string& input, const std::string& text, Matcher matcher) {
+    uint64_t count_of_entry = 0;
+    auto nanoseconds = MeasureNanoseconds([&]() {
+        matcher.Feed(text.data(), text.length(), [&count_of_entry](const uint64_t&) { ++count_of_entry; });
+    });
+    DoNotOptimize(count_of_entry);
+    ReportBenchmark(name, input, text.length(), nanoseconds);
+}
+
+int RunBenchmark() {
+    const size_t text_size = 1 << 24;
+    const size_t pattern_size = 24;
+
+    std::vector<std::pair<std::string, std::string>> texts = {
+        {"random", GenerateRandomString(text_size, "ab", 1)},
+        {"periodic", GeneratePeriodicString(text_size, "aaaaaaab")},
+        {"fibonacci", GenerateFibonacciString(text_size)},
+        {"sparse", GenerateRandomString(text_size, "abcdefghijklmnopqrstuvwxy", 1)},
+    };
+    // Plant a few entries of a pattern whose first symbol never occurs elsewhere in the sparse text.
+    auto& sparse = texts.back().second;
+    for (size_t position = 0; position + pattern_size < text_size; position += text_size / 16) {
+        sparse[position] = 'z';
+    }
+
+    for (auto& [input, text] : texts) {
+        auto str = text.substr(text_size / 2, pattern_size);
+        if (input == "sparse") {
+            str = sparse.substr(0, pattern_size);
+        }
+        BenchmarkMatcher("prefix_function", input, text, PrefixFunctionMatcher(str, nullptr));
+        BenchmarkMatcher("prefix_function_scalar_skip", input, text, PrefixFunctionMatcher(str, FindCandidateScalar));
+        BenchmarkMatcher("prefix_function_simd_skip", input, text, PrefixFunctionMatcher(str));
+        BenchmarkMatcher("automaton_16", input, text, PrefixFunctionAutomaton<uint16_t>(str, nullptr));
+        BenchmarkMatcher("automaton_32", input, text, PrefixFunctionAutomaton<uint32_t>(str, nullptr));
+        BenchmarkMatcher("automaton_16_simd_skip", input, text, PrefixFunctionAutomaton<uint16_t>(str));
+        for (uint32_t thread_count = 1; thread_count <= std::thread::hardware_concurrency(); thread_count *= 2) {
+            uint64_t count_of_entry = 0;
+            auto nanoseconds = MeasureNanoseconds(
+                [&]() { count_of_entry = FindEntryOfStringInTextParallel(text, str, thread_count).size(); });
+            DoNotOptimize(count_of_entry);
+            ReportBenchmark("parallel_" + std::to_string(thread_count) + "_threads", input, text.length(), nanoseconds);
+        }
+    }
+
+    RunScalingBenchmark(
+        "find_entry", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, [](std::string text) { return text; },
+        [](const std::string& text) -> uint64_t {
+            uint64_t count_of_entry = 0;
+            ForEachEntryOfStringInText(text, text.substr(text.size() / 2, 16),
+                                       [&count_of_entry](const uint64_t&) { ++count_of_entry; });
+            return count_of_entry;
+        });
+    RunScalingBenchmark(
+        "find_entry_prefix_function", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize,
+        [](std::string text) { return text; },
+        [](const std::string& text) -> uint64_t {
+            uint64_t count_of_entry = 0;
+            PrefixFunctionMatcher(text.substr(text.size() / 2, 16))
+                .Feed(text.data(), text.length(), [&count_of_entry](const uint64_t&) { ++count_of_entry; });
+            return count_of_entry;
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::string text;
-    std::string str;
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
 
-    std::cin >> text;
-    std::cin >> str;
+    FastReader input;
+    FastWriter output;
+    auto write_entry = [&output](const uint64_t& entry) { output << entry << '\n'; };
+
+    // The pattern comes after the text, so the text has to be kept somewhere until the pattern is read.
+    // A mapped file already keeps it; a piped text is spilled to a temporary file in chunks and mapped
+    // back. Either way the text is never copied into a string and may be larger than memory.
+    if (input.IsMapped()) {
+        auto text = input.ReadToken();
+        std::string str(input.ReadToken());
+        ForEachEntryOfStringInText(text, str, write_entry);
+        return 0;
+    }
+
+    FILE* spill = std::tmpfile();
+    if (spill == nullptr) {
+        return 1;
+    }
+    bool is_spilled = true;
+    input.ForEachChunkOfToken([&](std::string_view chunk) {
+        is_spilled = is_spilled && std::fwrite(chunk.data(), 1, chunk.size(), spill) == chunk.size();
+    });
+    std::string str(input.ReadToken());
+    if (!is_spilled || std::fflush(spill) != 0 || lseek(fileno(spill), 0, SEEK_SET) != 0) {
+        std::fclose(spill);
+        return 1;
+    }
 
-    auto number_of_entry = FindEntryOfStringInText(text, str);
-    for (auto& elem : number_of_entry) {
-        std::cout << elem << std::endl;
+    {
+        FastReader text_input(fileno(spill));
+        ForEachEntryOfStringInText(text_input.ReadToken(), str, write_entry);
     }
+    std::fclose(spill);
     return 0;
 }
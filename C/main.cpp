@@ -1,88 +1,150 @@
-#include <iostream>
 #include <string>
 #include <vector>
 
-std::vector<uint32_t> PrefixFunction(const std::string& str) {
-    std::vector<uint32_t> prefix(str.length(), 0);
-    for (uint32_t position = 1; position < str.length(); ++position) {
-        uint32_t current_len = prefix[position - 1];
-        while (current_len > 0) {
-            if (str[current_len] == str[position]) {
-                break;
-            }
-            current_len = prefix[current_len - 1];
-        }
-        if (str[position] == str[current_len]) {
-            ++current_len;
-        }
-        prefix[position] = current_len;
-    }
-    return prefix;
-}
+#include "../benchmark/counters.h"
+#include "../io/fast_io.h"
+#include "../prefix_function/prefix_function.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#include "../hash/substring_hash.h"
+#endif
 
 std::vector<uint32_t> FindEntryOfStringInText(const std::string& text, const std::string& str) {
     std::vector<uint32_t> number_of_entry;
-    char separator = '#';
-    std::string str_to_find = str + separator + text;
-    auto prefix = PrefixFunction(str_to_find);
-    for (uint32_t iteration = 0; iteration < prefix.size(); ++iteration) {
-        if (prefix[iteration] == str.length() && iteration >= 2 * str.length()) {
-            number_of_entry.push_back(iteration - 2 * str.length());
-        }
-    }
+    PrefixFunctionMatcher(str).ForEach(text, [&number_of_entry](const uint32_t& entry) {
+        number_of_entry.push_back(entry);
+        return true;
+    });
     return number_of_entry;
 }
 
 bool IsStringInText(const std::string& text, const std::string& str) {
-    auto number_of_entry = FindEntryOfStringInText(text, str);
-    return !number_of_entry.empty();
+    return PrefixFunctionMatcher(str).Contains(text);
 }
 
 enum Cases { THE_ZERO_IN_UNKNOWN_PLACE = 0, THE_ONE_IN_UNKNOWN_PLACE = 1, UNKNOWN = 2 };
 
-uint32_t WhatStandsInUnknownPlace(const std::string& str_before, const std::string& str_after) {
-    std::string str_before_with_zero = str_before + "0" + str_before;
-    std::string str_before_with_one = str_before + "1" + str_before;
+// Symbol of str_before + middle + str_before, without building the string.
+char GetSymbolOfDoubledString(const std::string& str, const char& middle, const uint32_t& position) {
+    if (position < str.length()) {
+        return str[position];
+    }
+    if (position == str.length()) {
+        return middle;
+    }
+    return str[position - str.length() - 1];
+}
 
-    std::string str_after_with_zero = str_after + "0";
-    std::string str_after_with_one = str_after + "1";
+// Both texts are str_before + c + str_before and both patterns are str_after + c, so one prefix
+// function of str_after answers all four questions: str_after + c occurs in a text exactly when
+// str_after ends right before a c. The two texts are walked side by side, and the scan stops as soon
+// as both symbols have been seen after str_after.
+uint32_t WhatStandsInUnknownPlace(const std::string& str_before, const std::string& str_after) {
+    PrefixFunctionMatcher matcher(str_after);
 
-    if (IsStringInText(str_before_with_zero, str_after_with_zero) ||
-        IsStringInText(str_before_with_one, str_after_with_zero)) {
-        if (!IsStringInText(str_before_with_zero, str_after_with_one) &&
-            !IsStringInText(str_before_with_one, str_after_with_one)) {
-            return THE_ZERO_IN_UNKNOWN_PLACE;
+    bool is_zero_after = false;
+    bool is_one_after = false;
+    auto check_next_symbol = [&](const uint32_t& current_len, const char& symbol) {
+        if (current_len == matcher.GetLength()) {
+            is_zero_after = is_zero_after || symbol == '0';
+            is_one_after = is_one_after || symbol == '1';
         }
-    }
+    };
 
-    if (IsStringInText(str_before_with_zero, str_after_with_one) ||
-        IsStringInText(str_before_with_one, str_after_with_one)) {
-        if (!IsStringInText(str_before_with_zero, str_after_with_zero) &&
-            !IsStringInText(str_before_with_one, str_after_with_zero)) {
-            return THE_ONE_IN_UNKNOWN_PLACE;
-        }
+    uint32_t current_len_with_zero = 0;
+    uint32_t current_len_with_one = 0;
+    uint32_t text_len = 2 * str_before.length() + 1;
+    for (uint32_t position = 0; position < text_len && !(is_zero_after && is_one_after); ++position) {
+        char symbol_with_zero = GetSymbolOfDoubledString(str_before, '0', position);
+        char symbol_with_one = GetSymbolOfDoubledString(str_before, '1', position);
+
+        check_next_symbol(current_len_with_zero, symbol_with_zero);
+        check_next_symbol(current_len_with_one, symbol_with_one);
+
+        current_len_with_zero = matcher.Step(current_len_with_zero, symbol_with_zero);
+        current_len_with_one = matcher.Step(current_len_with_one, symbol_with_one);
     }
 
+    if (is_zero_after && !is_one_after) {
+        return THE_ZERO_IN_UNKNOWN_PLACE;
+    }
+    if (is_one_after && !is_zero_after) {
+        return THE_ONE_IN_UNKNOWN_PLACE;
+    }
     return UNKNOWN;
 }
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    const size_t text_size = 1000 * 1000;
+    const size_t query_count = 1000;
+
+    auto text = GenerateRandomString(text_size, "01", 1);
+    std::vector<std::string> queries;
+    for (size_t iteration = 0; iteration < query_count; ++iteration) {
+        queries.push_back(GenerateRandomString(12 + iteration % 8, "01", iteration));
+    }
+
+    uint64_t count_of_found = 0;
+    auto nanoseconds = MeasureNanoseconds([&]() {
+        for (auto& str : queries) {
+            count_of_found += IsStringInText(text, str);
+        }
+    });
+    DoNotOptimize(count_of_found);
+    ReportRate("is_string_in_text", "prefix", query_count, nanoseconds, "queries");
+
+    nanoseconds = MeasureNanoseconds([&]() {
+        SubstringHashIndex index(text);
+        for (auto& str : queries) {
+            count_of_found += index.Contains(str);
+        }
+    });
+    DoNotOptimize(count_of_found);
+    ReportRate("is_string_in_text", "hash", query_count, nanoseconds, "queries");
+
+    nanoseconds = MeasureNanoseconds([&]() {
+        for (auto& count : SubstringHashIndex(text).CountBatch(queries)) {
+            count_of_found += count > 0;
+        }
+    });
+    DoNotOptimize(count_of_found);
+    ReportRate("is_string_in_text", "hash_batch", query_count, nanoseconds, "queries");
+
+    RunScalingBenchmark(
+        "what_stands_in_unknown_place", "01", kBenchmarkMaxSize, [](std::string str) { return str; },
+        [](const std::string& str) -> uint64_t {
+            return WhatStandsInUnknownPlace(str, str.substr(str.size() / 2, str.size() / 4));
+        });
+    return 0;
+}
+#endif
+
 int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     uint32_t string_len = 0;
-    std::cin >> string_len;
+    input >> string_len;
 
     std::string string_before;
-    std::cin >> string_before;
+    input >> string_before;
 
     std::string string_after;
-    std::cin >> string_after;
+    input >> string_after;
 
     uint32_t what_stands = WhatStandsInUnknownPlace(string_before, string_after);
     if (what_stands == THE_ZERO_IN_UNKNOWN_PLACE) {
-        std::cout << "No" << std::endl;
+        output << "No\n";
     } else if (what_stands == THE_ONE_IN_UNKNOWN_PLACE) {
-        std::cout << "Yes" << std::endl;
+        output << "Yes\n";
     } else {
-        std::cout << "Random" << std::endl;
+        output << "Random\n";
     }
 
     return 0;
@@ -1,53 +1,276 @@
-#include <iostream>
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
 
-std::vector<uint32_t> PrefixFunction(const std::string& str) {
-    std::vector<uint32_t> prefix(str.length(), 0);
-    for (uint32_t position = 1; position < str.length(); ++position) {
-        uint32_t current_len = prefix[position - 1];
-        while (current_len > 0) {
-            if (str[current_len] == str[position]) {
-                break;
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+const uint32_t kInfinity = 4000 * 1000 * 1000U;
+const uint32_t kSymbolCount = 256;
+const uint32_t kMaxDenseAlphabetSize = 16;
+const uint8_t kMaxBlockCapacityLog = 8;
+
+// Suffix automaton over a byte alphabet, at most 2n states and 3n transitions. With a known alphabet of at
+// most kMaxDenseAlphabetSize symbols every state owns a dense row of next vertices, one per symbol. Otherwise
+// the transitions of a state form a block sorted by symbol, found by binary search; blocks sit in one pool,
+// double when they fill up, and freed blocks are reused by later states of the same capacity.
+class SuffixAutomaton {
+private:
+    struct State {
+        uint32_t length = 0;
+        uint32_t link = kInfinity;
+        uint32_t first_transition = kInfinity;
+        uint16_t transition_count = 0;
+        uint8_t capacity_log = 0;
+    };
+
+    std::vector<State> states_;
+
+    // Dense rows, or sorted blocks with the symbols alongside, all in next_vertex_.
+    std::vector<uint32_t> next_vertex_;
+    std::vector<unsigned char> symbol_;
+    std::vector<uint32_t> free_blocks_[kMaxBlockCapacityLog + 1];
+
+    bool is_dense_ = false;
+    uint32_t alphabet_size_ = 0;
+    unsigned char code_of_symbol_[kSymbolCount] = {};
+
+    uint32_t last_ = 0;
+
+    uint64_t number_of_different_substring_ = 0;
+
+    uint32_t AllocateBlock(const uint8_t& capacity_log) {
+        if (!free_blocks_[capacity_log].empty()) {
+            uint32_t block = free_blocks_[capacity_log].back();
+            free_blocks_[capacity_log].pop_back();
+            return block;
+        }
+        uint32_t block = next_vertex_.size();
+        next_vertex_.resize(next_vertex_.size() + (1U << capacity_log), kInfinity);
+        symbol_.resize(next_vertex_.size(), 0);
+        return block;
+    }
+
+    // Index in next_vertex_ of the transition by symbol, or kInfinity when there is none.
+    uint32_t FindTransition(const uint32_t& vertex, const char& symbol) const {
+        if (is_dense_) {
+            uint32_t transition = vertex * alphabet_size_ + code_of_symbol_[static_cast<unsigned char>(symbol)];
+            return next_vertex_[transition] == kInfinity ? kInfinity : transition;
+        }
+        const State& state = states_[vertex];
+        if (state.transition_count == 0) {
+            return kInfinity;
+        }
+        auto begin = symbol_.begin() + state.first_transition;
+        auto it = std::lower_bound(begin, begin + state.transition_count, static_cast<unsigned char>(symbol));
+        if (it == begin + state.transition_count || *it != static_cast<unsigned char>(symbol)) {
+            return kInfinity;
+        }
+        return it - symbol_.begin();
+    }
+
+    uint32_t GetTransition(const uint32_t& vertex, const char& symbol) const {
+        uint32_t transition = FindTransition(vertex, symbol);
+        if (transition == kInfinity) {
+            return kInfinity;
+        }
+        return next_vertex_[transition];
+    }
+
+    void AddState(const uint32_t& length, const uint32_t& link) {
+        states_.push_back({length, link, kInfinity, 0, 0});
+        if (is_dense_) {
+            next_vertex_.resize(next_vertex_.size() + alphabet_size_, kInfinity);
+        }
+    }
+
+    // The transition must be missing.
+    void AddTransition(const uint32_t& vertex, const char& symbol, const uint32_t& next_vertex) {
+        if (is_dense_) {
+            next_vertex_[vertex * alphabet_size_ + code_of_symbol_[static_cast<unsigned char>(symbol)]] = next_vertex;
+            return;
+        }
+        State& state = states_[vertex];
+        if (state.first_transition == kInfinity) {
+            state.first_transition = AllocateBlock(0);
+        } else if (state.transition_count == (1U << state.capacity_log)) {
+            uint32_t block = AllocateBlock(state.capacity_log + 1);
+            std::copy_n(next_vertex_.begin() + state.first_transition, state.transition_count,
+                        next_vertex_.begin() + block);
+            std::copy_n(symbol_.begin() + state.first_transition, state.transition_count, symbol_.begin() + block);
+            free_blocks_[state.capacity_log].push_back(state.first_transition);
+            state.first_transition = block;
+            ++state.capacity_log;
+        }
+
+        uint32_t position = state.first_transition + state.transition_count;
+        while (position > state.first_transition && symbol_[position - 1] > static_cast<unsigned char>(symbol)) {
+            symbol_[position] = symbol_[position - 1];
+            next_vertex_[position] = next_vertex_[position - 1];
+            --position;
+        }
+        symbol_[position] = symbol;
+        next_vertex_[position] = next_vertex;
+        ++state.transition_count;
+    }
+
+    // to is a new state without transitions.
+    void CopyTransitions(const uint32_t& from, const uint32_t& to) {
+        if (is_dense_) {
+            std::copy_n(next_vertex_.begin() + from * alphabet_size_, alphabet_size_,
+                        next_vertex_.begin() + to * alphabet_size_);
+            return;
+        }
+        if (states_[from].transition_count == 0) {
+            return;
+        }
+        uint8_t capacity_log = states_[from].capacity_log;
+        uint32_t block = AllocateBlock(capacity_log);
+        const State& state = states_[from];
+        std::copy_n(next_vertex_.begin() + state.first_transition, state.transition_count,
+                    next_vertex_.begin() + block);
+        std::copy_n(symbol_.begin() + state.first_transition, state.transition_count, symbol_.begin() + block);
+        states_[to].first_transition = block;
+        states_[to].transition_count = state.transition_count;
+        states_[to].capacity_log = capacity_log;
+    }
+
+public:
+    // An alphabet of at most kMaxDenseAlphabetSize symbols selects dense rows, and then every symbol added
+    // has to be in it; an empty alphabet means any byte.
+    explicit SuffixAutomaton(const size_t& expected_length = 0, const std::string& alphabet = "") {
+        if (!alphabet.empty() && alphabet.size() <= kMaxDenseAlphabetSize) {
+            is_dense_ = true;
+            alphabet_size_ = alphabet.size();
+            for (uint32_t code = 0; code < alphabet_size_; ++code) {
+                code_of_symbol_[static_cast<unsigned char>(alphabet[code])] = code;
+            }
+            next_vertex_.reserve((2 * expected_length + 1) * alphabet_size_);
+        } else {
+            next_vertex_.reserve(4 * expected_length);
+            symbol_.reserve(4 * expected_length);
+        }
+        states_.reserve(2 * expected_length + 1);
+        AddState(0, kInfinity);
+    }
+
+    // Amortized O(1) per symbol with dense rows and O(log |alphabet|) with sorted blocks; the number of
+    // different substrings grows by the number of new suffixes, which is length(last) - length(link(last)).
+    void AddSymbol(const char& symbol) {
+        uint32_t current = states_.size();
+        AddState(states_[last_].length + 1, kInfinity);
+
+        uint32_t vertex = last_;
+        while (vertex != kInfinity && FindTransition(vertex, symbol) == kInfinity) {
+            AddTransition(vertex, symbol, current);
+            vertex = states_[vertex].link;
+        }
+
+        if (vertex == kInfinity) {
+            states_[current].link = 0;
+        } else {
+            uint32_t next_vertex = GetTransition(vertex, symbol);
+            if (states_[vertex].length + 1 == states_[next_vertex].length) {
+                states_[current].link = next_vertex;
+            } else {
+                uint32_t copy = states_.size();
+                AddState(states_[vertex].length + 1, states_[next_vertex].link);
+                CopyTransitions(next_vertex, copy);
+
+                uint32_t transition = FindTransition(vertex, symbol);
+                while (vertex != kInfinity && next_vertex_[transition] == next_vertex) {
+                    next_vertex_[transition] = copy;
+                    vertex = states_[vertex].link;
+                    if (vertex != kInfinity) {
+                        transition = FindTransition(vertex, symbol);
+                    }
+                }
+
+                states_[next_vertex].link = copy;
+                states_[current].link = copy;
             }
-            current_len = prefix[current_len - 1];
         }
-        if (str[position] == str[current_len]) {
-            ++current_len;
+
+        last_ = current;
+        number_of_different_substring_ += states_[current].length - states_[states_[current].link].length;
+    }
+
+    uint64_t GetNumberOfDifferentSubstring() const {
+        return number_of_different_substring_;
+    }
+};
+
+// The different symbols of str, in the order they first appear.
+std::string GetAlphabet(std::string_view str) {
+    bool is_seen[kSymbolCount] = {};
+    std::string alphabet;
+    for (auto& symbol : str) {
+        if (!is_seen[static_cast<unsigned char>(symbol)]) {
+            is_seen[static_cast<unsigned char>(symbol)] = true;
+            alphabet += symbol;
         }
-        prefix[position] = current_len;
     }
-    return prefix;
+    return alphabet;
 }
 
-std::string GetReverseString(const std::string& str) {
-    auto string_copy = str;
-    std::reverse(string_copy.begin(), string_copy.end());
-    return string_copy;
+uint64_t GetNumberOfDifferentSubstring(const std::string& str) {
+    SuffixAutomaton automaton(str.length(), GetAlphabet(str));
+    for (auto& symbol : str) {
+        automaton.AddSymbol(symbol);
+    }
+    return automaton.GetNumberOfDifferentSubstring();
 }
 
-uint32_t GetNumberOfDifferentSubstring(const std::string& str) {
-    std::string string_copy;
-    uint32_t number_of_different_substring = 0;
-    for (uint32_t symbol_position = 0; symbol_position < str.length(); ++symbol_position) {
-        string_copy += str[symbol_position];
-        auto string_reverse_copy = GetReverseString(string_copy);
-        auto prefix = PrefixFunction(string_reverse_copy);
-        uint32_t max_prefix = 0;
-        for (uint32_t iteration = 0; iteration < prefix.size(); ++iteration) {
-            max_prefix = std::max(max_prefix, prefix[iteration]);
-        }
-        number_of_different_substring += (string_copy.length() - max_prefix);
+// Reads one whitespace-delimited word from input and calls callback(count) with the number of different
+// substrings of every prefix. The word is read in place as a token and never copied.
+template <class Callback>
+void ForEachPrefixNumberOfDifferentSubstring(FastReader& input, Callback callback) {
+    auto word = input.ReadToken();
+    SuffixAutomaton automaton(word.size(), GetAlphabet(word));
+    for (auto& symbol : word) {
+        automaton.AddSymbol(symbol);
+        callback(automaton.GetNumberOfDifferentSubstring());
     }
+}
+
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "suffix_automaton", "abcdefghijklmnopqrstuvwxyz", 10 * 1000 * 1000, [](std::string str) { return str; },
+        [](const std::string& str) -> uint64_t { return GetNumberOfDifferentSubstring(str); });
 
-    return number_of_different_substring;
+    // Printable ASCII takes the sorted blocks, and four letters the dense rows.
+    std::string printable;
+    for (char symbol = '!'; symbol <= '~'; ++symbol) {
+        printable += symbol;
+    }
+    for (auto& alphabet : {printable, std::string("acgt")}) {
+        RunScalingBenchmark(
+            "suffix_automaton/" + std::to_string(alphabet.size()), alphabet, 10 * 1000 * 1000,
+            [](std::string str) { return str; },
+            [](const std::string& str) -> uint64_t { return GetNumberOfDifferentSubstring(str); });
+    }
+    return 0;
 }
+#endif
 
 int main() {
-    std::string str;
-    std::cin >> str;
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
+    uint64_t number_of_different_substring = 0;
+    ForEachPrefixNumberOfDifferentSubstring(input, [&number_of_different_substring](const uint64_t& count) {
+        number_of_different_substring = count;
+    });
 
-    std::cout << GetNumberOfDifferentSubstring(str) << std::endl;
+    output << number_of_different_substring << '\n';
     return 0;
 }
@@ -1,44 +1,150 @@
-#include <iostream>
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
-#include <set>
 
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+const uint32_t kAlphabetSize = 26;
+const uint32_t kAlphabetMask = (1U << kAlphabetSize) - 1;
+const char kBeginOfAlphabet = 'a';
+
+// Symbols forbidden at a position are collected as a bit mask over the alphabet, and the smallest
+// allowed one is its lowest zero bit. 'a' is always forbidden: it would give the position a border of 1.
 std::string GetMinStringFromPrefix(const std::vector<uint32_t>& prefix) {
-    std::string str;
-    for (uint32_t iteration = 0; iteration < prefix.size(); ++iteration) {
-        str += "a";
-    }
-    str[0] = 'a';
+    std::string str(prefix.size(), kBeginOfAlphabet);
     for (uint32_t iteration = 1; iteration < prefix.size(); ++iteration) {
         if (prefix[iteration] != 0) {
             str[iteration] = str[prefix[iteration] - 1];
             continue;
         }
-        std::set<char> symbols_that_cannot_be_used;
+        uint32_t symbols_that_cannot_be_used = 1;
         uint32_t current_prefix = prefix[iteration - 1];
         while (current_prefix > 0) {
-            symbols_that_cannot_be_used.insert(str[current_prefix]);
+            symbols_that_cannot_be_used |= 1U << (str[current_prefix] - kBeginOfAlphabet);
             current_prefix = prefix[current_prefix - 1];
         }
-        for (char current_symbol = 'b'; current_symbol <= 'z'; ++current_symbol) {
-            if (symbols_that_cannot_be_used.find(current_symbol) == symbols_that_cannot_be_used.end()) {
-                str[iteration] = current_symbol;
-                break;
-            }
+        uint32_t symbols_that_can_be_used = ~symbols_that_cannot_be_used & kAlphabetMask;
+        if (symbols_that_can_be_used != 0) {
+            str[iteration] = static_cast<char>(kBeginOfAlphabet + __builtin_ctz(symbols_that_can_be_used));
         }
     }
     return str;
 }
 
+// Applies function to every array of the batch on thread_count threads (0 means one per hardware
+// core); threads take the next array from a shared counter.
+template <class Function>
+std::vector<std::string> GetMinStringBatch(const std::vector<std::vector<uint32_t>>& arrays, Function function,
+                                           uint32_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1U, std::thread::hardware_concurrency());
+    }
+    thread_count = static_cast<uint32_t>(std::min<size_t>(thread_count, arrays.size()));
+
+    std::vector<std::string> strings(arrays.size());
+    std::atomic<size_t> next_array(0);
+    auto worker = [&]() {
+        for (size_t array = next_array++; array < arrays.size(); array = next_array++) {
+            strings[array] = function(arrays[array]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t iteration = 1; iteration < thread_count; ++iteration) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return strings;
+}
+
+std::vector<std::string> GetMinStringFromPrefixBatch(const std::vector<std::vector<uint32_t>>& prefixes,
+                                                     uint32_t thread_count = 0) {
+    return GetMinStringBatch(prefixes, GetMinStringFromPrefix, thread_count);
+}
+
+#ifdef BENCHMARK
+const size_t kBenchmarkBatchArrayLength = 1000;
+const size_t kBenchmarkCheckedBatchSize = 100 * 1000;
+
+// A corpus like the ones the batch mode is for: the prefix arrays of str cut into pieces of
+// kBenchmarkBatchArrayLength symbols.
+std::vector<std::vector<uint32_t>> GeneratePrefixArrays(const std::string& str) {
+    std::vector<std::vector<uint32_t>> prefixes;
+    for (size_t begin = 0; begin < str.size(); begin += kBenchmarkBatchArrayLength) {
+        prefixes.push_back(GeneratePrefixArray(str.substr(begin, kBenchmarkBatchArrayLength)));
+    }
+    return prefixes;
+}
+
+uint64_t GetChecksum(const std::vector<std::string>& strings) {
+    uint64_t checksum = 0;
+    for (auto& str : strings) {
+        checksum = checksum * 31 + static_cast<unsigned char>(str.back());
+    }
+    return checksum;
+}
+
+int RunBenchmark() {
+    // The batch has to give exactly the strings of one call per array.
+    for (auto& input : GetBenchmarkInputs("abcdefghijklmnopqrstuvwxyz")) {
+        auto prefixes = GeneratePrefixArrays(input.generate(kBenchmarkCheckedBatchSize));
+        auto strings = GetMinStringFromPrefixBatch(prefixes);
+        for (size_t iteration = 0; iteration < prefixes.size(); ++iteration) {
+            if (strings[iteration] != GetMinStringFromPrefix(prefixes[iteration])) {
+                std::cout << "min_string_from_prefix/batch differs from one call per array on " << input.name
+                          << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    RunScalingBenchmark("min_string_from_prefix", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, GeneratePrefixArray,
+                        [](const std::vector<uint32_t>& prefix) -> uint64_t {
+                            return GetMinStringFromPrefix(prefix).back();
+                        });
+    RunScalingBenchmark(
+        "min_string_from_prefix/single", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, GeneratePrefixArrays,
+        [](const std::vector<std::vector<uint32_t>>& prefixes) -> uint64_t {
+            std::vector<std::string> strings;
+            for (auto& prefix : prefixes) {
+                strings.push_back(GetMinStringFromPrefix(prefix));
+            }
+            return GetChecksum(strings);
+        });
+    RunScalingBenchmark(
+        "min_string_from_prefix/batch", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, GeneratePrefixArrays,
+        [](const std::vector<std::vector<uint32_t>>& prefixes) -> uint64_t {
+            return GetChecksum(GetMinStringFromPrefixBatch(prefixes));
+        });
+    return 0;
+}
+#endif
+
 int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     uint32_t string_size = 0;
-    std::cin >> string_size;
+    input >> string_size;
 
     std::vector<uint32_t> prefix(string_size, 0);
     for (uint32_t iteration = 0; iteration < string_size; ++iteration) {
-        std::cin >> prefix[iteration];
+        input >> prefix[iteration];
     }
 
-    std::cout << GetMinStringFromPrefix(prefix) << std::endl;
+    output << GetMinStringFromPrefix(prefix) << '\n';
     return 0;
 }
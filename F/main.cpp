@@ -1,16 +1,27 @@
-#include <iostream>
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-std::vector<uint32_t> PrefixFunction(const std::string& str) {
-    std::vector<uint32_t> prefix(str.length(), 0);
+#include "../benchmark/counters.h"
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+// Writes the prefix function of str into prefix, reusing its storage.
+void PrefixFunction(std::string_view str, std::vector<uint32_t>& prefix) {
+    COUNTER_ADD("prefix_function.symbols", str.size());
+    prefix.assign(str.length(), 0);
     for (uint32_t position = 1; position < str.length(); ++position) {
         uint32_t current_len = prefix[position - 1];
         while (current_len > 0) {
             if (str[current_len] == str[position]) {
                 break;
             }
+            COUNTER_INCREMENT("prefix_function.failure_steps");
             current_len = prefix[current_len - 1];
         }
         if (str[position] == str[current_len]) {
@@ -18,43 +29,112 @@ std::vector<uint32_t> PrefixFunction(const std::string& str) {
         }
         prefix[position] = current_len;
     }
-    return prefix;
 }
 
+// Glues words one by one, overlapping every new word with the longest suffix of the result that is
+// its prefix. The overlap is found by walking the tail of the result through the prefix function of
+// the word, so neither the tail nor str + "#" + tail is ever copied, and the prefix function lives in
+// one scratch buffer that stops growing after the longest word.
+class Encryptor {
+private:
+    std::string result_;
+    std::vector<uint32_t> prefix_;
+
+public:
+    explicit Encryptor(const size_t& expected_length = 0) {
+        result_.reserve(expected_length);
+    }
+
+    void AddWord(std::string_view str) {
+        size_t shift = 0;
+        if (str.size() < result_.size()) {
+            shift = result_.size() - str.size();
+        }
+
+        PrefixFunction(str, prefix_);
+        uint32_t current_len = 0;
+        for (size_t position = shift; position < result_.size(); ++position) {
+            while (current_len > 0) {
+                if (current_len < str.size() && str[current_len] == result_[position]) {
+                    break;
+                }
+                current_len = prefix_[current_len - 1];
+            }
+            if (current_len < str.size() && str[current_len] == result_[position]) {
+                ++current_len;
+            }
+        }
+
+        result_.append(str.substr(current_len));
+    }
+
+    // Hands the merged string over without a copy; the encryptor is left empty.
+    std::string TakeResult() {
+        return std::move(result_);
+    }
+};
+
 std::string Encryption(const std::vector<std::string>& dictionary) {
-    std::string result = dictionary[0];
-    for (uint32_t iteration = 1; iteration < dictionary.size(); ++iteration) {
-        auto str = dictionary[iteration];
+    size_t expected_length = 0;
+    for (auto& str : dictionary) {
+        expected_length += str.size();
+    }
+
+    Encryptor encryptor(expected_length);
+    for (auto& str : dictionary) {
+        encryptor.AddWord(str);
+    }
+    return encryptor.TakeResult();
+}
 
-        uint32_t shift = 0;
-        if (str.size() < result.size()) {
-            shift = result.size() - str.size();
+// Reads word_count words one at a time instead of loading the whole dictionary first; each word is
+// merged straight from the input buffer. The merged string is never longer than the words together,
+// so the unread part of a mapped input is enough to reserve it once.
+std::string EncryptionFromStream(FastReader& input, const uint32_t& word_count) {
+    Encryptor encryptor(input.GetUnreadMappedSize());
+    for (uint32_t iteration = 0; iteration < word_count; ++iteration) {
+        auto str = input.ReadToken();
+        if (str.empty()) {
+            break;
         }
+        encryptor.AddWord(str);
+    }
+    return encryptor.TakeResult();
+}
 
-        auto new_str = result.substr(shift);
-        std::string str_to_prefix = str + "#" + new_str;
-        auto prefix = PrefixFunction(str_to_prefix);
+#ifdef BENCHMARK
+int RunBenchmark() {
+    const size_t word_count = 1000 * 1000;
 
-        uint32_t prefix_back = prefix.size() - 1;
-        result += str.substr(prefix[prefix_back], str.size() - prefix[prefix_back]);
+    std::vector<std::pair<std::string, std::string>> alphabets = {{"binary", "ab"}, {"letters", "abcdefghij"}};
+    for (auto& [input, alphabet] : alphabets) {
+        auto text = GenerateRandomString(word_count * 8, alphabet, 1);
+        auto dictionary = GenerateWords(text, 8);
+
+        uint64_t result_length = 0;
+        auto nanoseconds = MeasureNanoseconds([&]() { result_length = Encryption(dictionary).size(); });
+        DoNotOptimize(result_length);
+        ReportRate("encryption", input, dictionary.size(), nanoseconds, "words");
     }
 
-    return result;
+    RunScalingBenchmark(
+        "encryption", "abcdefghij", kBenchmarkMaxSize, [](const std::string& str) { return GenerateWords(str, 8); },
+        [](const std::vector<std::string>& dictionary) -> uint64_t { return Encryption(dictionary).size(); });
+    return 0;
 }
+#endif
 
 int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
-    std::cout.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
 
-    uint32_t word_count = 0;
-    std::cin >> word_count;
+    FastReader input;
+    FastWriter output;
 
-    std::vector<std::string> dictionary(word_count);
-    for (uint32_t iteration = 0; iteration < word_count; ++iteration) {
-        std::cin >> dictionary[iteration];
-    }
+    uint32_t word_count = 0;
+    input >> word_count;
 
-    std::cout << Encryption(dictionary) << std::endl;
+    output << EncryptionFromStream(input, word_count) << '\n';
     return 0;
-}
\ No newline at end of file
+}
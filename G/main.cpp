@@ -1,8 +1,55 @@
-#include <iostream>
 #include <string>
 #include <vector>
 
-std::vector<uint32_t> ZFunction(const std::string& str) {
+#include "../io/fast_io.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STRINGS_X86_SIMD
+#endif
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+// Length of the common prefix of left and right, looking at no more than limit symbols.
+using MatchLengthT = uint32_t (*)(const char*, const char*, uint32_t);
+
+uint32_t MatchLengthScalar(const char* left, const char* right, uint32_t limit) {
+    uint32_t length = 0;
+    while (length < limit && left[length] == right[length]) {
+        ++length;
+    }
+    return length;
+}
+
+#ifdef STRINGS_X86_SIMD
+__attribute__((target("avx2"))) uint32_t MatchLengthAvx2(const char* left, const char* right, uint32_t limit) {
+    uint32_t length = 0;
+    for (; length + 32 <= limit; length += 32) {
+        __m256i left_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + length));
+        __m256i right_block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + length));
+        auto mismatch = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(left_block, right_block)));
+        if (mismatch != 0) {
+            return length + __builtin_ctz(mismatch);
+        }
+    }
+    return length + MatchLengthScalar(left + length, right + length, limit - length);
+}
+#endif
+
+MatchLengthT SelectMatchLength() {
+#ifdef STRINGS_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        return MatchLengthAvx2;
+    }
+#endif
+    return MatchLengthScalar;
+}
+
+const MatchLengthT kMatchLength = SelectMatchLength();
+
+std::vector<uint32_t> ZFunction(const std::string& str, MatchLengthT match_length = kMatchLength) {
     std::vector<uint32_t> z_block(str.length());
     z_block[0] = str.length();
     uint32_t left = 0;
@@ -14,9 +61,11 @@ std::vector<uint32_t> ZFunction(const std::string& str) {
                 z_block[iteration] = right - iteration + 1;
             }
         }
-        while (iteration + z_block[iteration] < str.length() &&
-               str[z_block[iteration]] == str[iteration + z_block[iteration]]) {
-            ++z_block[iteration];
+        // Most extensions stop at the first symbol, which is checked inline before calling the kernel.
+        uint32_t matched = z_block[iteration];
+        if (iteration + matched < str.length() && str[matched] == str[iteration + matched]) {
+            z_block[iteration] += match_length(str.data() + matched, str.data() + iteration + matched,
+                                               str.length() - iteration - matched);
         }
         if (z_block[iteration] + iteration - 1 > right) {
             left = iteration;
@@ -27,13 +76,52 @@ std::vector<uint32_t> ZFunction(const std::string& str) {
     return z_block;
 }
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    const size_t size = 1 << 24;
+
+    std::vector<std::pair<std::string, std::string>> strings = {
+        {"random", GenerateRandomString(size, "abcdefghijklmnopqrstuvwxyz", 1)},
+        {"one_letter", std::string(size, 'a')},
+        {"runs", GeneratePeriodicString(size, std::string(1000, 'a') + "b")},
+        {"fibonacci", GenerateFibonacciString(size)},
+    };
+    std::vector<std::pair<std::string, MatchLengthT>> kernels = {{"z_function_scalar", MatchLengthScalar},
+                                                                 {"z_function_dispatch", kMatchLength}};
+
+    for (auto& [input, str] : strings) {
+        for (auto& [name, match_length] : kernels) {
+            uint64_t z_sum = 0;
+            auto nanoseconds = MeasureNanoseconds([&]() {
+                auto z_block = ZFunction(str, match_length);
+                z_sum = z_block[str.length() / 2];
+            });
+            DoNotOptimize(z_sum);
+            ReportBenchmark(name, input, size, nanoseconds);
+        }
+    }
+
+    RunScalingBenchmark(
+        "z_function", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, [](std::string str) { return str; },
+        [](const std::string& str) -> uint64_t { return ZFunction(str).back(); });
+    return 0;
+}
+#endif
+
 int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     std::string str;
-    std::cin >> str;
+    input >> str;
 
     auto z_block = ZFunction(str);
     for (auto& elem : z_block) {
-        std::cout << elem << ' ';
+        output << elem << ' ';
     }
-    std::cout << std::endl;
+    output << '\n';
 }
@@ -1,84 +1,155 @@
 #include <vector>
 #include <algorithm>
+#include <limits>
 #include <string>
-#include <iostream>
-
-const uint64_t kInfinity = 1000 * 1000 * 1000 * 1LL;
-
-std::vector<uint64_t> ZFunction(const std::vector<uint64_t>& str) {
-    std::vector<uint64_t> z_block(str.size());
-    z_block[0] = str.size();
-    uint64_t left = 0;
-    uint64_t right = 0;
-    for (uint64_t iteration = 1; iteration < str.size(); ++iteration) {
-        if (iteration < right) {
-            z_block[iteration] = z_block[iteration - left];
-            if (right - iteration < z_block[iteration]) {
-                z_block[iteration] = right - iteration;
-            }
+
+#include "../hash/substring_hash.h"
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+// Manacher's radii of even palindromes: radius[center] is the largest k with
+// str[center - k, center + k) a palindrome.
+template <class SymbolT, class IndexT>
+std::vector<IndexT> EvenPalindromeRadius(const std::vector<SymbolT>& str) {
+    std::vector<IndexT> radius(str.size(), 0);
+    IndexT left = 0;
+    IndexT right = 0;
+    for (IndexT center = 0; center < str.size(); ++center) {
+        IndexT current_radius = 0;
+        if (center < right) {
+            current_radius = std::min(radius[left + right - center], static_cast<IndexT>(right - center));
         }
-        while (iteration + z_block[iteration] < str.size() &&
-               str[z_block[iteration]] == str[iteration + z_block[iteration]]) {
-            ++z_block[iteration];
+        while (center + current_radius < str.size() && current_radius < center &&
+               str[center + current_radius] == str[center - current_radius - 1]) {
+            ++current_radius;
         }
-        if (z_block[iteration] + iteration > right) {
-            left = iteration;
-            right = iteration + z_block[iteration];
+        radius[center] = current_radius;
+        if (center + current_radius > right) {
+            left = center - current_radius;
+            right = center + current_radius;
         }
     }
-
-    return z_block;
+    return radius;
 }
 
-std::vector<uint64_t> GetMirror(const std::vector<uint64_t>& cubes) {
-    auto reverse_cubes = cubes;
-    std::reverse(reverse_cubes.begin(), reverse_cubes.end());
-
-    std::vector<uint64_t> new_cubes(cubes.size() + reverse_cubes.size() + 1);
-    for (uint64_t iteration = 0; iteration < new_cubes.size(); ++iteration) {
-        if (iteration < cubes.size()) {
-            new_cubes[iteration] = cubes[iteration];
-        } else if (iteration == cubes.size()) {
-            new_cubes[iteration] = kInfinity;
-        } else {
-            new_cubes[iteration] = reverse_cubes[iteration - reverse_cubes.size() - 1];
+// The cubes can be folded after the first k of them exactly when the prefix of length 2k is an even
+// palindrome, i.e. when the palindrome centered at k reaches the beginning.
+template <class SymbolT, class IndexT>
+std::vector<uint64_t> GetMirror(const std::vector<SymbolT>& cubes) {
+    auto radius = EvenPalindromeRadius<SymbolT, IndexT>(cubes);
+
+    std::vector<uint64_t> mirror;
+    for (uint64_t half = cubes.size() / 2; half > 0; --half) {
+        if (radius[half] >= half) {
+            mirror.push_back(cubes.size() - half);
         }
     }
-    auto z_block = ZFunction(new_cubes);
+    mirror.push_back(cubes.size());
 
-    std::vector<uint64_t> z_block_for_reverse_cubes;
-    for (uint64_t iteration = cubes.size() + 1; iteration < z_block.size(); ++iteration) {
-        z_block_for_reverse_cubes.push_back(z_block[iteration]);
-    }
+    return mirror;
+}
 
-    std::vector<uint64_t> mirror;
-    for (uint64_t iteration = 0; iteration < z_block_for_reverse_cubes.size(); ++iteration) {
-        if (z_block_for_reverse_cubes[iteration] % 2 == 0) {
-            if (z_block_for_reverse_cubes[iteration] == z_block_for_reverse_cubes.size() - iteration) {
-                uint64_t count = cubes.size() - z_block_for_reverse_cubes[iteration] / 2;
-                mirror.push_back(count);
-            }
+// Streaming mode: takes count_cubes cubes from read_cube and calls callback(half) as soon as the first
+// 2 * half cubes form a mirror, in increasing order of half, keeping O(1) memory. A prefix is recognized
+// as a palindrome by comparing its polynomial hash read forwards and backwards, so a match is correct
+// with high probability rather than always. Colors must be below kHashModulo to stay distinct.
+template <class ReadCube, class Callback>
+void ForEachMirrorOfStream(ReadCube read_cube, const int64_t& count_cubes, Callback callback) {
+    uint64_t forward_hash = 0;
+    uint64_t backward_hash = 0;
+    uint64_t power = 1;
+    for (int64_t iteration = 0; iteration < count_cubes; ++iteration) {
+        uint64_t cube = static_cast<uint64_t>(read_cube()) % kHashModulo + 1;
+
+        forward_hash = AddModulo(forward_hash, MultiplyModulo(cube, power));
+        backward_hash = AddModulo(MultiplyModulo(backward_hash, kHashBase), cube);
+        power = MultiplyModulo(power, kHashBase);
+
+        if (iteration % 2 == 1 && forward_hash == backward_hash) {
+            callback((iteration + 1) / 2);
         }
     }
-    mirror.push_back(cubes.size());
+}
 
+// Same answer as GetMirror, but only the mirrors are kept, not the cubes.
+std::vector<uint64_t> ReadCubesAndGetMirrorOfStream(FastReader& input, const int64_t& count_cubes) {
+    std::vector<uint64_t> mirror;
+    ForEachMirrorOfStream([&input]() { return input.ReadInteger<uint64_t>(); }, count_cubes,
+                          [&mirror, &count_cubes](const uint64_t& half) { mirror.push_back(count_cubes - half); });
+    std::reverse(mirror.begin(), mirror.end());
+    mirror.push_back(count_cubes);
     return mirror;
 }
 
+template <class SymbolT>
+std::vector<uint64_t> ReadCubesAndGetMirror(FastReader& input, const int64_t& count_cubes) {
+    std::vector<SymbolT> cubes(count_cubes);
+    for (int64_t iteration = 0; iteration < count_cubes; ++iteration) {
+        cubes[iteration] = static_cast<SymbolT>(input.ReadInteger<uint64_t>());
+    }
+
+    if (static_cast<uint64_t>(count_cubes) < std::numeric_limits<uint32_t>::max()) {
+        return GetMirror<SymbolT, uint32_t>(cubes);
+    }
+    return GetMirror<SymbolT, uint64_t>(cubes);
+}
+
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "mirror", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize,
+        [](const std::string& str) {
+            std::vector<uint8_t> cubes(str.size());
+            for (size_t iteration = 0; iteration < str.size(); ++iteration) {
+                cubes[iteration] = str[iteration] - 'a' + 1;
+            }
+            return cubes;
+        },
+        [](const std::vector<uint8_t>& cubes) -> uint64_t { return GetMirror<uint8_t, uint32_t>(cubes).size(); });
+    RunScalingBenchmark(
+        "mirror/stream", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, [](std::string str) { return str; },
+        [](const std::string& str) -> uint64_t {
+            size_t position = 0;
+            uint64_t count_of_mirror = 0;
+            ForEachMirrorOfStream([&str, &position]() { return str[position++] - 'a' + 1; }, str.size(),
+                                  [&count_of_mirror](const uint64_t&) { ++count_of_mirror; });
+            return count_of_mirror;
+        });
+    return 0;
+}
+#endif
+
 int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     int64_t count_cubes = 0;
     int64_t alphabet_size = 0;
-    std::cin >> count_cubes >> alphabet_size;
+    input >> count_cubes >> alphabet_size;
 
-    std::vector<uint64_t> cubes(count_cubes);
-    for (int64_t iteration = 0; iteration < count_cubes; ++iteration) {
-        std::cin >> cubes[iteration];
+    // The narrowest storage that holds every color. Wide colors would take 4 or 8 bytes per cube next to
+    // the 4-byte radius, so those are hashed as they are read instead of being stored.
+    std::vector<uint64_t> mirror;
+    if (alphabet_size <= std::numeric_limits<uint8_t>::max()) {
+        mirror = ReadCubesAndGetMirror<uint8_t>(input, count_cubes);
+    } else if (alphabet_size <= std::numeric_limits<uint16_t>::max()) {
+        mirror = ReadCubesAndGetMirror<uint16_t>(input, count_cubes);
+    } else if (static_cast<uint64_t>(alphabet_size) < kHashModulo) {
+        mirror = ReadCubesAndGetMirrorOfStream(input, count_cubes);
+    } else {
+        mirror = ReadCubesAndGetMirror<uint64_t>(input, count_cubes);
     }
 
-    auto mirror = GetMirror(cubes);
     for (auto& elem : mirror) {
-        std::cout << elem << ' ';
+        output << elem << ' ';
     }
-    std::cout << std::endl;
+    output << '\n';
     return 0;
 }
@@ -1,16 +1,94 @@
-#include <iostream>
 #include <algorithm>
+#include <bitset>
 #include <string>
+#include <string_view>
 #include <vector>
 
-std::vector<uint32_t> PrefixFunction(const std::string& str) {
-    std::vector<uint32_t> prefix(str.length(), 0);
-    for (uint32_t position = 1; position < str.length(); ++position) {
+#include "../benchmark/counters.h"
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+const size_t kByteAlphabetSize = 256;
+const uint32_t kSeparator = kByteAlphabetSize;
+
+// Several strings glued with a separator, presented as one random-access sequence without copying
+// them. Symbols are bytes widened to uint32_t, and the separator lies outside the byte alphabet, so
+// it never matches anything inside the strings, whatever they contain.
+class ConcatenatedView {
+private:
+    std::vector<std::string_view> parts_;
+    std::vector<size_t> begin_of_part_;
+
+    size_t first_part_size_ = 0;
+    size_t second_part_begin_ = 0;
+
+public:
+    explicit ConcatenatedView(const std::vector<std::string_view>& parts) {
+        parts_ = parts;
+        size_t begin = 0;
+        for (auto& part : parts_) {
+            begin_of_part_.push_back(begin);
+            begin += part.size() + 1;
+        }
+        if (!parts_.empty()) {
+            first_part_size_ = parts_.front().size();
+            second_part_begin_ = first_part_size_ + 1;
+        }
+    }
+
+    size_t size() const {
+        return parts_.empty() ? 0 : begin_of_part_.back() + parts_.back().size();
+    }
+
+    // The first part and the part right after it are found with plain compares: with two parts, the
+    // common case, no access searches the offsets at all.
+    // Calls callback(symbol) for every symbol in order, separators included.
+    template <class Callback>
+    void ForEachSymbol(Callback callback) const {
+        for (size_t part = 0; part < parts_.size(); ++part) {
+            if (part > 0) {
+                callback(kSeparator);
+            }
+            for (auto& symbol : parts_[part]) {
+                callback(static_cast<unsigned char>(symbol));
+            }
+        }
+    }
+
+    uint32_t operator[](const size_t& position) const {
+        if (position < first_part_size_) {
+            return static_cast<unsigned char>(parts_.front()[position]);
+        }
+        if (position == first_part_size_) {
+            return kSeparator;
+        }
+        if (parts_.size() == 2 && position - second_part_begin_ < parts_.back().size()) {
+            return static_cast<unsigned char>(parts_.back()[position - second_part_begin_]);
+        }
+        auto it = std::upper_bound(begin_of_part_.begin(), begin_of_part_.end(), position);
+        size_t part = it - begin_of_part_.begin() - 1;
+        size_t shift = position - begin_of_part_[part];
+        if (shift == parts_[part].size()) {
+            return kSeparator;
+        }
+        return static_cast<unsigned char>(parts_[part][shift]);
+    }
+};
+
+template <class SequenceT>
+std::vector<uint32_t> PrefixFunction(const SequenceT& str) {
+    COUNTER_ADD("prefix_function.symbols", str.size());
+    std::vector<uint32_t> prefix(str.size(), 0);
+    for (uint32_t position = 1; position < str.size(); ++position) {
         uint32_t current_len = prefix[position - 1];
         while (current_len > 0) {
             if (str[current_len] == str[position]) {
                 break;
             }
+            COUNTER_INCREMENT("prefix_function.failure_steps");
             current_len = prefix[current_len - 1];
         }
         if (str[position] == str[current_len]) {
@@ -21,10 +99,39 @@ std::vector<uint32_t> PrefixFunction(const std::string& str) {
     return prefix;
 }
 
-std::vector<std::string> SplitOneWordIntoPrefixesOfAnotherWord(const std::string& word_of_prefix,
-                                                               const std::string& split_word) {
-    std::string string_to_prefix = word_of_prefix + "#" + split_word;
-    auto prefix = PrefixFunction(string_to_prefix);
+// PrefixFunction for a ConcatenatedView: the symbol at position is read part by part in order, and only the
+// symbol at current_len goes through operator[], which rarely leaves the first part.
+template <>
+std::vector<uint32_t> PrefixFunction(const ConcatenatedView& str) {
+    COUNTER_ADD("prefix_function.symbols", str.size());
+    std::vector<uint32_t> prefix(str.size(), 0);
+    uint32_t current_len = 0;
+    uint32_t position = 0;
+    str.ForEachSymbol([&](const uint32_t& symbol) {
+        if (position > 0) {
+            while (current_len > 0 && str[current_len] != symbol) {
+                COUNTER_INCREMENT("prefix_function.failure_steps");
+                current_len = prefix[current_len - 1];
+            }
+            if (str[current_len] == symbol) {
+                ++current_len;
+            }
+            prefix[position] = current_len;
+        }
+        ++position;
+    });
+    return prefix;
+}
+
+// The pieces are returned as views into split_word, so split_word has to outlive the result.
+std::vector<std::string_view> SplitOneWordIntoPrefixesOfAnotherWord(const std::string& word_of_prefix,
+                                                                    const std::string& split_word) {
+    auto prefix = PrefixFunction(ConcatenatedView({word_of_prefix, split_word}));
+
+    std::bitset<kByteAlphabetSize> is_symbol_in_word_of_prefix;
+    for (auto& symbol : word_of_prefix) {
+        is_symbol_in_word_of_prefix[static_cast<unsigned char>(symbol)] = true;
+    }
 
     for (uint32_t iteration = 0; iteration < prefix.size(); ++iteration) {
         if (iteration > word_of_prefix.size()) {
@@ -33,17 +140,18 @@ std::vector<std::string> SplitOneWordIntoPrefixesOfAnotherWord(const std::string
             }
         }
         if (iteration < split_word.size()) {
-            if (word_of_prefix.find(split_word[iteration]) == std::string::npos) {
+            if (!is_symbol_in_word_of_prefix[static_cast<unsigned char>(split_word[iteration])]) {
                 return {};
             }
         }
     }
 
-    std::vector<std::string> prefixes;
+    std::vector<std::string_view> prefixes;
+    std::string_view split_word_view(split_word);
+    uint32_t shift = word_of_prefix.length() + 1;
 
     for (uint32_t position = prefix.size() - 1; position > word_of_prefix.length();) {
-        auto new_prefix = string_to_prefix.substr(position - prefix[position] + 1, prefix[position]);
-        prefixes.push_back(new_prefix);
+        prefixes.push_back(split_word_view.substr(position - shift - prefix[position] + 1, prefix[position]));
         position -= prefix[position];
     }
 
@@ -51,24 +159,39 @@ std::vector<std::string> SplitOneWordIntoPrefixesOfAnotherWord(const std::string
     return prefixes;
 }
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "split_into_prefixes", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, [](std::string str) { return str; },
+        [](const std::string& str) -> uint64_t {
+            return SplitOneWordIntoPrefixesOfAnotherWord(str.substr(0, 64), str).size();
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
 
     std::string first_word;
-    std::cin >> first_word;
+    input >> first_word;
 
     std::string last_word;
-    std::cin >> last_word;
+    input >> last_word;
 
     auto list_of_prefixes = SplitOneWordIntoPrefixesOfAnotherWord(first_word, last_word);
     if (list_of_prefixes.empty()) {
-        std::cout << "Yes" << std::endl;
+        output << "Yes\n";
     } else {
-        std::cout << "No" << std::endl;
+        output << "No\n";
         for (auto& str : list_of_prefixes) {
-            std::cout << str << ' ';
+            output << str << ' ';
         }
-        std::cout << std::endl;
+        output << '\n';
     }
 }
\ No newline at end of file
@@ -1,34 +1,37 @@
-#include <iostream>
 #include <string>
 #include <vector>
 
-std::vector<uint32_t> PrefixFunction(const std::string& str) {
-    std::vector<uint32_t> prefix(str.length(), 0);
-    for (uint32_t position = 1; position < str.length(); ++position) {
-        uint32_t current_len = prefix[position - 1];
-        while (current_len > 0) {
-            if (str[current_len] == str[position]) {
-                break;
-            }
-            current_len = prefix[current_len - 1];
-        }
-        if (str[position] == str[current_len]) {
-            ++current_len;
-        }
-        prefix[position] = current_len;
-    }
-    return prefix;
-}
+#include "../benchmark/counters.h"
+#include "../hash/substring_hash.h"
+#include "../io/fast_io.h"
+#include "../prefix_function/prefix_function.h"
 
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
+// Same count as scanning the prefix function of text + "#" + str + str, but that join is never built. When
+// text and str have the same length, a cyclic shift of str equals text exactly where text occurs in str + str
+// without its last symbol, which Count finds. For other lengths the text part of that prefix function is the
+// prefix function of text itself, and the str + str part is the match state of text walked over str twice,
+// which is counted on the fly.
 uint32_t FindNumberOfCyclicPermutationsOfStringInText(const std::string& text, const std::string& str) {
-    std::string string_to_prefix = text + "#" + str + str;
-    string_to_prefix.resize(string_to_prefix.size());
+    PrefixFunctionMatcher matcher(text);
+    if (text.length() == str.length() && !str.empty()) {
+        return matcher.Count(str + str.substr(0, str.length() - 1));
+    }
 
     uint32_t number_of_cyclic_permutation_of_string_in_text = 0;
+    for (auto& elem : matcher.GetPrefix()) {
+        if (elem >= str.size()) {
+            ++number_of_cyclic_permutation_of_string_in_text;
+        }
+    }
 
-    auto prefix = PrefixFunction(string_to_prefix);
-    for (uint32_t iteration = 0; iteration < prefix.size(); ++iteration) {
-        if (iteration != prefix.size() - 1 && prefix[iteration] >= str.size()) {
+    uint32_t current_len = 0;
+    for (uint32_t iteration = 0; iteration + 1 < 2 * str.size(); ++iteration) {
+        current_len = matcher.Step(current_len, str[iteration % str.size()]);
+        if (current_len >= str.size()) {
             ++number_of_cyclic_permutation_of_string_in_text;
         }
     }
@@ -36,14 +39,121 @@ uint32_t FindNumberOfCyclicPermutationsOfStringInText(const std::string& text, c
     return number_of_cyclic_permutation_of_string_in_text;
 }
 
+// Counts, over all windows of a fixed text, the pairs (window, shift) for which the cyclic shift of
+// a query string equals the window. Windows of each length are fingerprinted once, on the first
+// query of that length; after that a query hashes its distinct cyclic shifts in O(|str|) and sums the
+// counts. For a text of the same length as str this equals FindNumberOfCyclicPermutationsOfStringInText.
+class CyclicPermutationIndex {
+private:
+    SubstringHashIndex text_index_;
+
+public:
+    explicit CyclicPermutationIndex(const std::string& text) : text_index_(text) {
+    }
+
+    uint64_t Count(const std::string& str) {
+        if (str.empty() || str.length() > text_index_.GetLength()) {
+            return 0;
+        }
+        auto& windows = text_index_.GetWindows(str.length());
+
+        // Shifts repeat with the smallest period of str that divides its length.
+        auto prefix = PrefixFunction(str);
+        uint32_t period = str.length() - prefix.back();
+        if (str.length() % period != 0) {
+            period = str.length();
+        }
+
+        PolynomialHash str_hash(str);
+        uint64_t count_of_window = 0;
+        for (uint32_t shift = 0; shift < period; ++shift) {
+            uint64_t tail = MultiplyModulo(str_hash.GetHash(shift, str.length() - shift), str_hash.GetPower(shift));
+            auto it = windows.find(AddModulo(tail, str_hash.GetHash(0, shift)));
+            if (it != windows.end()) {
+                count_of_window += it->second;
+            }
+        }
+        return count_of_window * (str.length() / period);
+    }
+};
+
+#ifdef BENCHMARK
+const uint32_t kBenchmarkQueryLength = 32;
+const size_t kBenchmarkQueryCount = 1000;
+const size_t kBenchmarkCheckedTextSize = 2000;
+const size_t kBenchmarkCheckedQueryCount = 100;
+
+// Cyclic shifts of windows spread over the text, so every query has at least one match.
+std::vector<std::string> GenerateQueries(const std::string& text, const size_t& query_count) {
+    std::vector<std::string> queries;
+    if (text.size() < kBenchmarkQueryLength) {
+        return queries;
+    }
+    size_t window_count = text.size() - kBenchmarkQueryLength + 1;
+    for (size_t iteration = 0; iteration < query_count; ++iteration) {
+        auto window = text.substr(iteration * 7919 % window_count, kBenchmarkQueryLength);
+        uint32_t shift = iteration % kBenchmarkQueryLength;
+        queries.push_back(window.substr(shift) + window.substr(0, shift));
+    }
+    return queries;
+}
+
+int RunBenchmark() {
+    // The index has to give the per-window sum of FindNumberOfCyclicPermutationsOfStringInText.
+    for (auto& input : GetBenchmarkInputs("abcdefghijklmnopqrstuvwxyz")) {
+        auto text = input.generate(kBenchmarkCheckedTextSize);
+        CyclicPermutationIndex index(text);
+        for (auto& query : GenerateQueries(text, kBenchmarkCheckedQueryCount)) {
+            uint64_t count_of_window = 0;
+            for (size_t begin = 0; begin + query.size() <= text.size(); ++begin) {
+                auto window = text.substr(begin, query.size());
+                count_of_window += FindNumberOfCyclicPermutationsOfStringInText(window, query);
+            }
+            if (index.Count(query) != count_of_window) {
+                std::cout << "cyclic_permutations/index differs from one count per window on " << input.name
+                          << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    RunScalingBenchmark(
+        "cyclic_permutations", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize, [](std::string str) { return str; },
+        [](const std::string& text) -> uint64_t {
+            auto str = text.substr(text.size() / 3) + text.substr(0, text.size() / 3);
+            return FindNumberOfCyclicPermutationsOfStringInText(text, str);
+        });
+    // One index build, then kBenchmarkQueryCount queries against it.
+    RunScalingBenchmark(
+        "cyclic_permutations/index", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize,
+        [](std::string str) { return str; },
+        [](const std::string& text) -> uint64_t {
+            CyclicPermutationIndex index(text);
+            uint64_t count_of_window = 0;
+            for (auto& query : GenerateQueries(text, kBenchmarkQueryCount)) {
+                count_of_window += index.Count(query);
+            }
+            return count_of_window;
+        });
+    return 0;
+}
+#endif
+
 int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     std::string str;
-    std::cin >> str;
+    input >> str;
 
     std::string text;
-    std::cin >> text;
+    input >> text;
 
-    std::cout << FindNumberOfCyclicPermutationsOfStringInText(text, str) << std::endl;
+    output << FindNumberOfCyclicPermutationsOfStringInText(text, str) << '\n';
 
     return 0;
 }
@@ -1,103 +1,1003 @@
-#include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
 
 const uint32_t kAlphabetSize = 26;
 const char kBeginOfAlphabet = 'a';
 
+const size_t kNoMemoryBudget = 0;
+const uint32_t kNoState = std::numeric_limits<uint32_t>::max();
+const uint8_t kMaxTrialsOfFreeCell = 16;
+
+// Nodes live in one contiguous arena: the children of node v are the alphabet_size 32-bit slots starting
+// at v * alphabet_size, and 0 marks a missing child, since the root is never anyone's child. A node costs
+// 4 * alphabet_size + 4 bytes and no pointer is ever reference-counted. With a memory budget the arena is
+// reserved up front and never grows past it.
 class Bohr {
 private:
-    struct Node {
-        std::vector<std::shared_ptr<Node>> next_vertex;
+    std::vector<uint32_t> next_vertex_;
+    std::vector<uint32_t> count_string_that_end_at_this_vertex_;
 
-        uint32_t count_string_that_end_at_this_vertex = 0;
+    uint32_t alphabet_size_ = 0;
 
-        char symbol = 0;
+    char symbol_of_beginning_of_alphabet_ = 0;
 
-        explicit Node(const uint32_t& alphabet_size, const char& current_symbol) {
-            next_vertex.resize(alphabet_size, nullptr);
-            count_string_that_end_at_this_vertex = 0;
-            symbol = current_symbol;
-        }
-    };
+    size_t max_node_count_ = 0;
 
-    std::shared_ptr<Node> root_;
+    size_t GetChildSlot(const uint32_t& vertex, const uint32_t& position) const {
+        return static_cast<size_t>(vertex) * alphabet_size_ + position;
+    }
 
-    uint32_t alphabet_size_ = 0;
+    size_t GetChildSlot(const uint32_t& vertex, const char& symbol) const {
+        return GetChildSlot(vertex, static_cast<uint32_t>(symbol - symbol_of_beginning_of_alphabet_));
+    }
 
-    char symbol_of_beginning_of_alphabet_ = 0;
+    uint32_t AddNode() {
+        next_vertex_.resize(next_vertex_.size() + alphabet_size_, 0);
+        count_string_that_end_at_this_vertex_.push_back(0);
+        return count_string_that_end_at_this_vertex_.size() - 1;
+    }
 
 public:
-    explicit Bohr(const uint32_t& alphabet_size, const char& symbol_of_beginning_of_alphabet) {
+    explicit Bohr(const uint32_t& alphabet_size, const char& symbol_of_beginning_of_alphabet,
+                  const size_t& memory_budget = kNoMemoryBudget) {
         alphabet_size_ = alphabet_size;
-        root_ = std::make_shared<Node>(alphabet_size, '#');
         symbol_of_beginning_of_alphabet_ = symbol_of_beginning_of_alphabet;
+
+        max_node_count_ = std::numeric_limits<uint32_t>::max();
+        if (memory_budget != kNoMemoryBudget) {
+            max_node_count_ = std::min(max_node_count_, std::max<size_t>(memory_budget / GetNodeSize(), 1));
+            next_vertex_.reserve(max_node_count_ * alphabet_size_);
+            count_string_that_end_at_this_vertex_.reserve(max_node_count_);
+        }
+        AddNode();
     }
 
-    void AddNewString(const std::string& str) {
-        std::shared_ptr<Node> current_vertex = root_;
+    uint32_t GetAlphabetSize() const {
+        return alphabet_size_;
+    }
 
-        for (uint32_t iteration = 0; iteration < str.length(); ++iteration) {
-            char symbol = str[iteration];
-            uint32_t position = symbol - symbol_of_beginning_of_alphabet_;
+    char GetSymbolOfBeginningOfAlphabet() const {
+        return symbol_of_beginning_of_alphabet_;
+    }
+
+    size_t GetNodeSize() const {
+        return (alphabet_size_ + 1) * sizeof(uint32_t);
+    }
+
+    size_t GetNodeCount() const {
+        return count_string_that_end_at_this_vertex_.size();
+    }
+
+    size_t GetMemoryUsage() const {
+        return next_vertex_.capacity() * sizeof(uint32_t) +
+               count_string_that_end_at_this_vertex_.capacity() * sizeof(uint32_t);
+    }
+
+    // Node-level access for code that walks or builds the trie without going through strings; vertex 0
+    // is the root, and a child of 0 means there is none.
+    uint32_t GetChild(const uint32_t& vertex, const uint32_t& position) const {
+        return next_vertex_[GetChildSlot(vertex, position)];
+    }
+
+    uint32_t GetCount(const uint32_t& vertex) const {
+        return count_string_that_end_at_this_vertex_[vertex];
+    }
+
+    // Steps for the batched lookups, which treat Bohr and DoubleArrayTrie alike: the next state is kNoState
+    // when the child is missing.
+    uint32_t GetNextState(const uint32_t& vertex, const char& symbol) const {
+        uint32_t next_vertex = next_vertex_[GetChildSlot(vertex, symbol)];
+        return next_vertex == 0 ? kNoState : next_vertex;
+    }
+
+    bool IsFinalState(const uint32_t& vertex) const {
+        return count_string_that_end_at_this_vertex_[vertex] > 0;
+    }
 
-            if (current_vertex->next_vertex[position] == nullptr) {
-                current_vertex->next_vertex[position] = std::make_shared<Node>(alphabet_size_, symbol);
+    void PrefetchNextState(const uint32_t& vertex, const char& symbol) const {
+        __builtin_prefetch(&next_vertex_[GetChildSlot(vertex, symbol)]);
+    }
+
+    // Returns 0 when the child is missing and does not fit in the memory budget.
+    uint32_t GetOrAddChild(const uint32_t& vertex, const uint32_t& position) {
+        if (next_vertex_[GetChildSlot(vertex, position)] == 0 && GetNodeCount() < max_node_count_) {
+            uint32_t new_vertex = AddNode();
+            next_vertex_[GetChildSlot(vertex, position)] = new_vertex;
+        }
+        return next_vertex_[GetChildSlot(vertex, position)];
+    }
+
+    void AddCount(const uint32_t& vertex, const uint32_t& count) {
+        count_string_that_end_at_this_vertex_[vertex] += count;
+    }
+
+    // Adds every word of other, with its multiplicity, in one walk over the nodes of other. Returns false,
+    // leaving the trie unchanged, when the new nodes would not fit in the memory budget; a first walk
+    // counts them, with kNoState standing for a vertex that is not here yet.
+    bool AddAllStrings(const Bohr& other) {
+        size_t count_of_new_nodes = 0;
+        std::vector<std::pair<uint32_t, uint32_t>> stack = {{0, 0}};
+        while (!stack.empty()) {
+            auto [other_vertex, vertex] = stack.back();
+            stack.pop_back();
+            for (uint32_t position = 0; position < alphabet_size_; ++position) {
+                uint32_t other_child = other.GetChild(other_vertex, position);
+                if (other_child == 0) {
+                    continue;
+                }
+                uint32_t child = vertex == kNoState ? 0 : GetChild(vertex, position);
+                if (child == 0) {
+                    ++count_of_new_nodes;
+                    child = kNoState;
+                }
+                stack.emplace_back(other_child, child);
+            }
+        }
+        if (GetNodeCount() + count_of_new_nodes > max_node_count_) {
+            return false;
+        }
+
+        stack = {{0, 0}};
+        while (!stack.empty()) {
+            auto [other_vertex, vertex] = stack.back();
+            stack.pop_back();
+            AddCount(vertex, other.GetCount(other_vertex));
+            for (uint32_t position = 0; position < alphabet_size_; ++position) {
+                uint32_t other_child = other.GetChild(other_vertex, position);
+                if (other_child != 0) {
+                    stack.emplace_back(other_child, GetOrAddChild(vertex, position));
+                }
+            }
+        }
+        return true;
+    }
+
+    // Returns false, leaving the trie unchanged, when the new nodes would not fit in the memory budget.
+    bool AddNewString(std::string_view str) {
+        uint32_t current_vertex = 0;
+        uint32_t length_in_bohr = 0;
+        while (length_in_bohr < str.length()) {
+            uint32_t next_vertex = next_vertex_[GetChildSlot(current_vertex, str[length_in_bohr])];
+            if (next_vertex == 0) {
+                break;
             }
+            current_vertex = next_vertex;
+            ++length_in_bohr;
+        }
 
-            current_vertex = current_vertex->next_vertex[position];
+        if (GetNodeCount() + (str.length() - length_in_bohr) > max_node_count_) {
+            return false;
         }
 
-        current_vertex->count_string_that_end_at_this_vertex += 1;
+        for (uint32_t iteration = length_in_bohr; iteration < str.length(); ++iteration) {
+            uint32_t new_vertex = AddNode();
+            next_vertex_[GetChildSlot(current_vertex, str[iteration])] = new_vertex;
+            current_vertex = new_vertex;
+        }
+
+        count_string_that_end_at_this_vertex_[current_vertex] += 1;
+        return true;
     }
 
-    bool IsThisStringInBohr(const std::string& str) const {
-        std::shared_ptr<Node> current_vertex = root_;
+    bool IsThisStringInBohr(std::string_view str) const {
+        uint32_t current_vertex = 0;
 
         for (uint32_t iteration = 0; iteration < str.length(); ++iteration) {
-            char symbol = str[iteration];
-            uint32_t position = symbol - symbol_of_beginning_of_alphabet_;
-            current_vertex = current_vertex->next_vertex[position];
-            if (current_vertex == nullptr) {
+            current_vertex = next_vertex_[GetChildSlot(current_vertex, str[iteration])];
+            if (current_vertex == 0) {
                 return false;
             }
         }
 
-        return current_vertex->count_string_that_end_at_this_vertex;
+        return count_string_that_end_at_this_vertex_[current_vertex] > 0;
     }
 };
 
-int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
 
-    std::string request_type;
-    std::string word;
+// Read-only double-array form of a Bohr. The child of state s by symbol code c (position in the alphabet
+// plus one) is the cell base[s] + c, and it exists exactly when check[base[s] + c] == s, so a lookup reads
+// two array cells per symbol. The root is cell 0, and a state with no children keeps base 0. While it is
+// built, the free cells form a doubly linked list in position order with cell 0 as its head, so a base
+// search visits only free cells, as in darts-clone and cedar. A free cell that failed as the start of a base
+// kMaxTrialsOfFreeCell times is left out of the list for good, so holes between dense states are not
+// scanned over and over.
+class DoubleArrayTrie {
+private:
+    std::vector<uint32_t> base_;
+    std::vector<uint32_t> check_;
+    std::vector<uint32_t> count_string_that_end_at_this_state_;
+
+    uint32_t alphabet_size_ = 0;
+
+    char symbol_of_beginning_of_alphabet_ = 0;
+
+    size_t state_count_ = 0;
+
+    std::vector<uint32_t> next_free_cell_;
+    std::vector<uint32_t> previous_free_cell_;
+    std::vector<uint8_t> trial_count_of_free_cell_;
+
+    // Grows the arrays to at least size cells and appends the new cells to the tail of the free list.
+    void Reserve(const size_t& size) {
+        size_t old_size = check_.size();
+        if (size <= old_size) {
+            return;
+        }
+        size_t new_size = std::max(size, 2 * old_size);
+        base_.resize(new_size, 0);
+        check_.resize(new_size, kNoState);
+        count_string_that_end_at_this_state_.resize(new_size, 0);
+        next_free_cell_.resize(new_size, 0);
+        previous_free_cell_.resize(new_size, 0);
+        trial_count_of_free_cell_.resize(new_size, 0);
+        for (size_t cell = std::max<size_t>(old_size, 1); cell < new_size; ++cell) {
+            uint32_t tail = previous_free_cell_[0];
+            next_free_cell_[tail] = cell;
+            previous_free_cell_[cell] = tail;
+            next_free_cell_[cell] = 0;
+            previous_free_cell_[0] = cell;
+        }
+    }
+
+    void UnlinkFreeCell(const uint32_t& cell) {
+        next_free_cell_[previous_free_cell_[cell]] = next_free_cell_[cell];
+        previous_free_cell_[next_free_cell_[cell]] = previous_free_cell_[cell];
+    }
+
+    void TakeCell(const uint32_t& cell, const uint32_t& state) {
+        check_[cell] = state;
+        UnlinkFreeCell(cell);
+    }
+
+    // First base at which every code lands on a free cell, trying the free cells for the smallest code in
+    // order and growing the arrays once they run out.
+    uint32_t FindBase(const std::vector<uint32_t>& codes) {
+        uint32_t cell = next_free_cell_[0];
+        while (true) {
+            if (cell == 0) {
+                cell = check_.size();
+                Reserve(cell + 1);
+            }
+            if (cell >= codes.front()) {
+                size_t base = cell - codes.front();
+                Reserve(base + codes.back() + 1);
+                bool is_fit = true;
+                for (auto& code : codes) {
+                    if (check_[base + code] != kNoState) {
+                        is_fit = false;
+                        break;
+                    }
+                }
+                if (is_fit) {
+                    return base;
+                }
+                if (++trial_count_of_free_cell_[cell] == kMaxTrialsOfFreeCell) {
+                    UnlinkFreeCell(cell);
+                }
+            }
+            cell = next_free_cell_[cell];
+        }
+    }
+
+public:
+    explicit DoubleArrayTrie(const Bohr& bohr) {
+        alphabet_size_ = bohr.GetAlphabetSize();
+        symbol_of_beginning_of_alphabet_ = bohr.GetSymbolOfBeginningOfAlphabet();
+        state_count_ = bohr.GetNodeCount();
+
+        Reserve(alphabet_size_ + 1);
+        check_[0] = 0;
+        count_string_that_end_at_this_state_[0] = bohr.GetCount(0);
+
+        // Depth-first over the Bohr, as pairs of vertex and the cell it was given. The nodes of a word were
+        // added one after another, so this order reads the arena nearly in sequence and gives the states of
+        // a word cells close together; breadth-first order took twice as long on both counts.
+        std::vector<std::pair<uint32_t, uint32_t>> stack = {{0, 0}};
+        std::vector<uint32_t> codes;
+        std::vector<uint32_t> children;
+        size_t size = 1;
+        while (!stack.empty()) {
+            auto [vertex, state] = stack.back();
+            stack.pop_back();
+            codes.clear();
+            children.clear();
+            for (uint32_t position = 0; position < alphabet_size_; ++position) {
+                uint32_t child = bohr.GetChild(vertex, position);
+                if (child != 0) {
+                    codes.push_back(position + 1);
+                    children.push_back(child);
+                }
+            }
+            if (codes.empty()) {
+                continue;
+            }
+
+            uint32_t base = FindBase(codes);
+            base_[state] = base;
+            for (uint32_t iteration = 0; iteration < codes.size(); ++iteration) {
+                uint32_t child_state = base + codes[iteration];
+                TakeCell(child_state, state);
+                count_string_that_end_at_this_state_[child_state] = bohr.GetCount(children[iteration]);
+                stack.emplace_back(children[iteration], child_state);
+                size = std::max<size_t>(size, child_state + 1);
+            }
+        }
+
+        base_.resize(size);
+        check_.resize(size);
+        count_string_that_end_at_this_state_.resize(size);
+        base_.shrink_to_fit();
+        check_.shrink_to_fit();
+        count_string_that_end_at_this_state_.shrink_to_fit();
+        std::vector<uint32_t>().swap(next_free_cell_);
+        std::vector<uint32_t>().swap(previous_free_cell_);
+        std::vector<uint8_t>().swap(trial_count_of_free_cell_);
+    }
+
+    size_t GetStateCount() const {
+        return state_count_;
+    }
+
+    size_t GetMemoryUsage() const {
+        return (base_.capacity() + check_.capacity() + count_string_that_end_at_this_state_.capacity()) *
+               sizeof(uint32_t);
+    }
+
+    uint32_t GetNextState(const uint32_t& state, const char& symbol) const {
+        size_t next_state =
+            static_cast<size_t>(base_[state]) + static_cast<uint32_t>(symbol - symbol_of_beginning_of_alphabet_) + 1;
+        if (next_state >= check_.size() || check_[next_state] != state) {
+            return kNoState;
+        }
+        return next_state;
+    }
+
+    bool IsFinalState(const uint32_t& state) const {
+        return count_string_that_end_at_this_state_[state] > 0;
+    }
+
+    // Only the base of the state can be fetched ahead: the cell of the child depends on it.
+    void PrefetchNextState(const uint32_t& state, const char& /*symbol*/) const {
+        __builtin_prefetch(&base_[state]);
+    }
+
+    bool IsThisStringInTrie(std::string_view str) const {
+        uint32_t state = 0;
+        for (auto& symbol : str) {
+            state = GetNextState(state, symbol);
+            if (state == kNoState) {
+                return false;
+            }
+        }
+        return IsFinalState(state);
+    }
+
+    // The Bohr this double array was built from, rebuilt state by state.
+    Bohr ToBohr() const {
+        Bohr bohr(alphabet_size_, symbol_of_beginning_of_alphabet_);
+        std::vector<std::pair<uint32_t, uint32_t>> stack = {{0, 0}};
+        while (!stack.empty()) {
+            auto [state, vertex] = stack.back();
+            stack.pop_back();
+            bohr.AddCount(vertex, count_string_that_end_at_this_state_[state]);
+            for (uint32_t position = 0; position < alphabet_size_; ++position) {
+                size_t child_state = static_cast<size_t>(base_[state]) + position + 1;
+                if (child_state < check_.size() && check_[child_state] == state) {
+                    stack.emplace_back(child_state, bohr.GetOrAddChild(vertex, position));
+                }
+            }
+        }
+        return bohr;
+    }
+};
+
+const uint32_t kInterleavedQueryCount = 8;
+const size_t kLookupBatchSize = 1 << 16;
+
+// Batched lookups for any trie with the root at state 0 and the GetNextState, IsFinalState and
+// PrefetchNextState steps, that is Bohr and DoubleArrayTrie. Each returns one answer per query, in the
+// order of the queries.
+
+// Keeps the path of the previous query as a stack of cursors, so a query is walked only from the point
+// where it stops sharing a prefix with the previous one. Any order gives the right answers; in sorted
+// order every prefix shared inside the batch is walked once.
+template <class TrieT>
+std::vector<uint8_t> FindSortedStringsInTrie(const TrieT& trie, const std::vector<std::string_view>& queries) {
+    std::vector<uint8_t> is_found(queries.size(), 0);
+    std::vector<uint32_t> cursors = {0};
+    std::string_view previous_query;
+    for (size_t iteration = 0; iteration < queries.size(); ++iteration) {
+        auto query = queries[iteration];
+        size_t common_length = 0;
+        size_t max_common_length = std::min(query.size(), cursors.size() - 1);
+        while (common_length < max_common_length && query[common_length] == previous_query[common_length]) {
+            ++common_length;
+        }
+        cursors.resize(common_length + 1);
+
+        while (cursors.size() <= query.size()) {
+            uint32_t next_state = trie.GetNextState(cursors.back(), query[cursors.size() - 1]);
+            if (next_state == kNoState) {
+                break;
+            }
+            cursors.push_back(next_state);
+        }
+        is_found[iteration] = cursors.size() > query.size() && trie.IsFinalState(cursors.back());
+        previous_query = query;
+    }
+    return is_found;
+}
+
+// Sorts the batch, answers it with FindSortedStringsInTrie and puts the answers back in query order.
+template <class TrieT>
+std::vector<uint8_t> FindStringsInTrie(const TrieT& trie, const std::vector<std::string_view>& queries) {
+    std::vector<size_t> order(queries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&queries](const size_t& lhs, const size_t& rhs) {
+        return queries[lhs] < queries[rhs];
+    });
+    std::vector<std::string_view> sorted_queries(queries.size());
+    for (size_t iteration = 0; iteration < order.size(); ++iteration) {
+        sorted_queries[iteration] = queries[order[iteration]];
+    }
+
+    auto is_found_in_sorted_order = FindSortedStringsInTrie(trie, sorted_queries);
+    std::vector<uint8_t> is_found(queries.size(), 0);
+    for (size_t iteration = 0; iteration < order.size(); ++iteration) {
+        is_found[order[iteration]] = is_found_in_sorted_order[iteration];
+    }
+    return is_found;
+}
+
+// Walks kInterleavedQueryCount queries in turns, one symbol per turn, and prefetches what a query reads
+// next before switching to the others, so the cache misses of independent queries overlap instead of
+// waiting on one another. A finished query hands its place to the next one of the batch.
+template <class TrieT>
+std::vector<uint8_t> FindStringsInTrieInterleaved(const TrieT& trie, const std::vector<std::string_view>& queries) {
+    struct Cursor {
+        size_t query = 0;
+        uint32_t length = 0;
+        uint32_t state = 0;
+    };
+
+    std::vector<uint8_t> is_found(queries.size(), 0);
+    Cursor cursors[kInterleavedQueryCount];
+    size_t next_query = 0;
+    uint32_t active_count = 0;
+    while (active_count < kInterleavedQueryCount && next_query < queries.size()) {
+        cursors[active_count++] = {next_query++, 0, 0};
+    }
+
+    while (active_count > 0) {
+        for (uint32_t iteration = 0; iteration < active_count;) {
+            Cursor& cursor = cursors[iteration];
+            auto query = queries[cursor.query];
+            if (cursor.state != kNoState && cursor.length < query.size()) {
+                cursor.state = trie.GetNextState(cursor.state, query[cursor.length]);
+                ++cursor.length;
+                if (cursor.state != kNoState && cursor.length < query.size()) {
+                    trie.PrefetchNextState(cursor.state, query[cursor.length]);
+                }
+                ++iteration;
+                continue;
+            }
+
+            is_found[cursor.query] = cursor.state != kNoState && trie.IsFinalState(cursor.state);
+            if (next_query < queries.size()) {
+                cursor = {next_query++, 0, 0};
+            } else {
+                cursor = cursors[--active_count];
+            }
+        }
+    }
+    return is_found;
+}
+
+const size_t kMinOverlayNodeCount = 1 << 16;
+const size_t kMinLookupRunToFreeze = 1 << 16;
+const size_t kLookupsPerNodeToFreeze = 4;
 
+// Dictionary for the read-mostly phase: lookups go to a frozen double array, words added after freezing
+// go to a Bohr overlay, and the overlay is merged into a rebuilt double array once it outgrows both
+// kMinOverlayNodeCount and the frozen states. Every merge at least doubles the double array, so each node
+// takes part in at most two rebuilds on average.
+class FrozenBohr {
+private:
+    DoubleArrayTrie frozen_;
+    Bohr overlay_;
+
+public:
+    explicit FrozenBohr(const Bohr& bohr)
+        : frozen_(bohr), overlay_(bohr.GetAlphabetSize(), bohr.GetSymbolOfBeginningOfAlphabet()) {
+    }
+
+    // Returns false, keeping the overlay as it is, when the merged Bohr would run out of node indices.
+    bool Merge() {
+        Bohr merged = frozen_.ToBohr();
+        if (!merged.AddAllStrings(overlay_)) {
+            return false;
+        }
+        frozen_ = DoubleArrayTrie(merged);
+        overlay_ = Bohr(merged.GetAlphabetSize(), merged.GetSymbolOfBeginningOfAlphabet());
+        return true;
+    }
+
+    // Returns false, leaving the dictionary unchanged, when the overlay runs out of node indices. A merge
+    // that fails only leaves the word in the overlay.
+    bool AddNewString(std::string_view str) {
+        if (!overlay_.AddNewString(str)) {
+            return false;
+        }
+        if (overlay_.GetNodeCount() > std::max(kMinOverlayNodeCount, frozen_.GetStateCount())) {
+            Merge();
+        }
+        return true;
+    }
+
+    bool IsThisStringInBohr(std::string_view str) const {
+        return frozen_.IsThisStringInTrie(str) || overlay_.IsThisStringInBohr(str);
+    }
+
+    // IsThisStringInBohr for a whole batch, interleaved, which beats sorting on long random queries; the
+    // overlay is asked only about what the frozen part lacks.
+    std::vector<uint8_t> FindStringsInBohr(const std::vector<std::string_view>& queries) const {
+        auto is_found = FindStringsInTrieInterleaved(frozen_, queries);
+        if (overlay_.GetNodeCount() > 1) {
+            for (size_t iteration = 0; iteration < queries.size(); ++iteration) {
+                is_found[iteration] = is_found[iteration] || overlay_.IsThisStringInBohr(queries[iteration]);
+            }
+        }
+        return is_found;
+    }
+};
+
+const size_t kQueriesPerBatch = 1 << 10;
+
+// Trie shared by one writer and any number of readers without locks. Nodes live in an arena allocated
+// up front for max_node_count nodes and never move; a new node is fully zeroed before the writer
+// publishes it by a release store into its parent's child slot, and readers follow slots with acquire
+// loads, so a reader either misses the new child or sees it complete. A word becomes visible to
+// readers with the release store of its end counter. AddNewString must be called by one thread at a
+// time; IsThisStringInBohr may run on any number of threads alongside it.
+class ConcurrentBohr {
+private:
+    std::unique_ptr<std::atomic<uint32_t>[]> next_vertex_;
+    std::unique_ptr<std::atomic<uint32_t>[]> count_string_that_end_at_this_vertex_;
+
+    uint32_t alphabet_size_ = 0;
+
+    char symbol_of_beginning_of_alphabet_ = 0;
+
+    size_t max_node_count_ = 0;
+    std::atomic<size_t> node_count_{1};
+
+    size_t GetChildSlot(const uint32_t& vertex, const char& symbol) const {
+        uint32_t position = symbol - symbol_of_beginning_of_alphabet_;
+        return static_cast<size_t>(vertex) * alphabet_size_ + position;
+    }
+
+public:
+    explicit ConcurrentBohr(const uint32_t& alphabet_size, const char& symbol_of_beginning_of_alphabet,
+                            const size_t& max_node_count) {
+        alphabet_size_ = alphabet_size;
+        symbol_of_beginning_of_alphabet_ = symbol_of_beginning_of_alphabet;
+        max_node_count_ = std::min<size_t>(std::max<size_t>(max_node_count, 1), std::numeric_limits<uint32_t>::max());
+        next_vertex_.reset(new std::atomic<uint32_t>[max_node_count_ * alphabet_size_]());
+        count_string_that_end_at_this_vertex_.reset(new std::atomic<uint32_t>[max_node_count_]());
+    }
+
+    size_t GetNodeCount() const {
+        return node_count_.load(std::memory_order_relaxed);
+    }
+
+    // Returns false, leaving the trie unchanged, when the new nodes would not fit in the arena.
+    bool AddNewString(std::string_view str) {
+        uint32_t current_vertex = 0;
+        uint32_t length_in_bohr = 0;
+        while (length_in_bohr < str.length()) {
+            auto& slot = next_vertex_[GetChildSlot(current_vertex, str[length_in_bohr])];
+            uint32_t next_vertex = slot.load(std::memory_order_relaxed);
+            if (next_vertex == 0) {
+                break;
+            }
+            current_vertex = next_vertex;
+            ++length_in_bohr;
+        }
+
+        size_t node_count = node_count_.load(std::memory_order_relaxed);
+        if (node_count + (str.length() - length_in_bohr) > max_node_count_) {
+            return false;
+        }
+
+        for (uint32_t iteration = length_in_bohr; iteration < str.length(); ++iteration) {
+            uint32_t new_vertex = node_count++;
+            next_vertex_[GetChildSlot(current_vertex, str[iteration])].store(new_vertex, std::memory_order_release);
+            current_vertex = new_vertex;
+        }
+        node_count_.store(node_count, std::memory_order_relaxed);
+
+        auto& count = count_string_that_end_at_this_vertex_[current_vertex];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool IsThisStringInBohr(std::string_view str) const {
+        uint32_t current_vertex = 0;
+        for (auto& symbol : str) {
+            current_vertex = next_vertex_[GetChildSlot(current_vertex, symbol)].load(std::memory_order_acquire);
+            if (current_vertex == 0) {
+                return false;
+            }
+        }
+        return count_string_that_end_at_this_vertex_[current_vertex].load(std::memory_order_acquire) > 0;
+    }
+};
+
+// Answers every query against dictionary on thread_count threads (0 means one per hardware core); the
+// threads take batches of kQueriesPerBatch queries from a shared counter. A writer may keep adding words
+// meanwhile, and each answer then reflects some moment during the call.
+std::vector<uint8_t> FindStringsInBohrParallel(const ConcurrentBohr& dictionary,
+                                               const std::vector<std::string_view>& queries,
+                                               uint32_t thread_count = 0) {
+    if (thread_count == 0) {
+        thread_count = std::max(1U, std::thread::hardware_concurrency());
+    }
+    size_t batch_count = (queries.size() + kQueriesPerBatch - 1) / kQueriesPerBatch;
+    thread_count = static_cast<uint32_t>(std::max<size_t>(1, std::min<size_t>(thread_count, batch_count)));
+
+    std::vector<uint8_t> is_found(queries.size(), 0);
+    std::atomic<size_t> next_batch(0);
+    auto worker = [&]() {
+        for (size_t batch = next_batch++; batch < batch_count; batch = next_batch++) {
+            size_t end = std::min(queries.size(), (batch + 1) * kQueriesPerBatch);
+            for (size_t query = batch * kQueriesPerBatch; query < end; ++query) {
+                is_found[query] = dictionary.IsThisStringInBohr(queries[query]);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t iteration = 1; iteration < thread_count; ++iteration) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return is_found;
+}
+
+// Answers "+ word" and "? word" requests until "#". Words go to an arena Bohr while they keep coming. With
+// is_freezing, a run of kMinLookupRunToFreeze lookups in a row marks the read-mostly phase: the dictionary is
+// then frozen into a FrozenBohr, whose double array takes a tenth of the memory, and later words go to its
+// overlay. A freeze costs about as much as building the Bohr again, so short runs between words never
+// trigger it. A run of lookups is answered in batches of up to lookup_batch_size, which give the same answers
+// since nothing changes the dictionary inside the run; the words are copied because a token only lives until
+// the next read, and runs shorter than kInterleavedQueryCount are answered one by one.
+void AnswerRequests(FastReader& input, FastWriter& output, const size_t& lookup_batch_size = kLookupBatchSize,
+                    const bool& is_freezing = true) {
     Bohr dictionary(kAlphabetSize, kBeginOfAlphabet);
+    std::optional<FrozenBohr> frozen_dictionary;
+    size_t lookup_run_length = 0;
+
+    std::string batch_text;
+    std::vector<size_t> batch_ends;
+    std::vector<std::string_view> batch;
+    auto answer_batch = [&]() {
+        batch.clear();
+        size_t begin = 0;
+        for (auto& end : batch_ends) {
+            batch.push_back(std::string_view(batch_text).substr(begin, end - begin));
+            begin = end;
+        }
+        auto print_answer = [&output](const bool& is_word_in_bohr) {
+            if (is_word_in_bohr) {
+                output << "YES\n";
+            } else {
+                output << "NO\n";
+            }
+        };
+        if (is_freezing && !frozen_dictionary &&
+            lookup_run_length >= std::max(kMinLookupRunToFreeze, kLookupsPerNodeToFreeze * dictionary.GetNodeCount())) {
+            frozen_dictionary.emplace(dictionary);
+            dictionary = Bohr(kAlphabetSize, kBeginOfAlphabet);
+        }
+        if (batch.size() < kInterleavedQueryCount) {
+            for (auto& word : batch) {
+                print_answer(frozen_dictionary ? frozen_dictionary->IsThisStringInBohr(word)
+                                               : dictionary.IsThisStringInBohr(word));
+            }
+        } else {
+            auto is_found = frozen_dictionary ? frozen_dictionary->FindStringsInBohr(batch)
+                                              : FindStringsInTrieInterleaved(dictionary, batch);
+            for (auto& is_word_in_bohr : is_found) {
+                print_answer(is_word_in_bohr);
+            }
+        }
+        batch_text.clear();
+        batch_ends.clear();
+    };
 
     while (true) {
-        std::cin >> request_type;
+        auto request_type = input.ReadToken();
+        if (request_type != "?" && !batch_ends.empty()) {
+            answer_batch();
+        }
         if (request_type == "#") {
             break;
         }
         if (request_type == "+") {
-            std::cin >> word;
-            dictionary.AddNewString(word);
+            // The dictionary has no budget, so this fails only past 2^32 nodes; it ends input like a broken request.
+            lookup_run_length = 0;
+            auto word = input.ReadToken();
+            if (!(frozen_dictionary ? frozen_dictionary->AddNewString(word) : dictionary.AddNewString(word))) {
+                output << "¯\\_(ツ)_/¯\n";
+                break;
+            }
         } else if (request_type == "?") {
-            std::cin >> word;
-            bool is_word_in_bohr = dictionary.IsThisStringInBohr(word);
-            if (is_word_in_bohr) {
-                std::cout << "YES" << std::endl;
-            } else {
-                std::cout << "NO" << std::endl;
+            ++lookup_run_length;
+            batch_text += input.ReadToken();
+            batch_ends.push_back(batch_text.size());
+            if (batch_ends.size() == lookup_batch_size) {
+                answer_batch();
             }
         } else {
-            std::cout << "¯\\_(ツ)_/¯" << std::endl;
+            output << "¯\\_(ツ)_/¯\n";
             break;
         }
     }
+}
+
+#ifdef BENCHMARK
+int RunBenchmark() {
+    const size_t word_count = 1000 * 1000;
+    const size_t query_count = 4 * word_count;
+
+    auto text = GenerateRandomString(8 * word_count, "abcdefghijklmnopqrstuvwxyz", 1);
+    std::vector<std::string_view> words;
+    for (size_t position = 0; position + 12 <= text.size(); position += 8) {
+        words.push_back(std::string_view(text).substr(position, 3 + position % 10));
+    }
+
+    // Build times from every eighth, fourth and second word, the last being the dictionary below: a flat
+    // rate per node means the builds are linear.
+    for (size_t stride = 8; stride >= 2; stride /= 2) {
+        Bohr partial_dictionary(kAlphabetSize, kBeginOfAlphabet);
+        auto build_nanoseconds = MeasureNanoseconds([&]() {
+            for (size_t iteration = 0; iteration < words.size(); iteration += stride) {
+                partial_dictionary.AddNewString(words[iteration]);
+            }
+        });
+        size_t node_count = partial_dictionary.GetNodeCount();
+        ReportRate("bohr_build/arena", "1/" + std::to_string(stride), node_count, build_nanoseconds, "nodes");
+        build_nanoseconds =
+            MeasureNanoseconds([&]() { DoNotOptimize(DoubleArrayTrie(partial_dictionary).GetStateCount()); });
+        ReportRate("bohr_build/double_array", "1/" + std::to_string(stride), node_count, build_nanoseconds, "nodes");
+    }
+
+    Bohr dictionary(kAlphabetSize, kBeginOfAlphabet);
+    for (size_t iteration = 0; iteration < words.size(); iteration += 2) {
+        dictionary.AddNewString(words[iteration]);
+    }
+    DoubleArrayTrie frozen_dictionary(dictionary);
+
+    uint64_t count_of_found = 0;
+    auto nanoseconds = MeasureNanoseconds([&]() {
+        for (size_t iteration = 0; iteration < query_count; ++iteration) {
+            count_of_found += dictionary.IsThisStringInBohr(words[iteration % words.size()]);
+        }
+    });
+    DoNotOptimize(count_of_found);
+    ReportRate("bohr_lookup", "arena", query_count, nanoseconds, "queries");
+
+    nanoseconds = MeasureNanoseconds([&]() {
+        for (size_t iteration = 0; iteration < query_count; ++iteration) {
+            count_of_found += frozen_dictionary.IsThisStringInTrie(words[iteration % words.size()]);
+        }
+    });
+    DoNotOptimize(count_of_found);
+    ReportRate("bohr_lookup", "double_array", query_count, nanoseconds, "queries");
+    std::cout << "bohr_lookup memory: arena " << dictionary.GetMemoryUsage() / (1 << 20) << " MB, double_array "
+              << frozen_dictionary.GetMemoryUsage() / (1 << 20) << " MB" << std::endl;
+
+    // Batched lookups of path-like words, glued from a few hundred segments as URL paths are: one by one,
+    // sorted with shared prefixes walked once, and interleaved with prefetching.
+    std::mt19937_64 generator(1);
+    std::vector<std::string> segments;
+    for (size_t iteration = 0; iteration < 200; ++iteration) {
+        segments.push_back(GenerateRandomString(3 + iteration % 6, "abcdefghijklmnopqrstuvwxyz", generator()));
+    }
+    std::vector<std::string> paths(word_count / 5);
+    for (auto& path : paths) {
+        for (size_t depth = 2 + generator() % 4; depth > 0; --depth) {
+            path += segments[std::min(generator() % segments.size(), generator() % segments.size())];
+        }
+        path += GenerateRandomString(4, "abcdefghijklmnopqrstuvwxyz", generator());
+    }
+    Bohr path_dictionary(kAlphabetSize, kBeginOfAlphabet);
+    for (size_t iteration = 0; iteration < paths.size(); iteration += 2) {
+        path_dictionary.AddNewString(paths[iteration]);
+    }
+    DoubleArrayTrie frozen_path_dictionary(path_dictionary);
+    std::vector<std::string_view> path_queries;
+    for (size_t iteration = 0; iteration < query_count / 5; ++iteration) {
+        path_queries.push_back(paths[generator() % paths.size()]);
+    }
+
+    auto report_batches = [&](const std::string& layout, const std::string& variant, auto find_strings) {
+        auto batch_nanoseconds = MeasureNanoseconds([&]() {
+            for (size_t begin = 0; begin < path_queries.size(); begin += kLookupBatchSize) {
+                size_t end = std::min(path_queries.size(), begin + kLookupBatchSize);
+                std::vector<std::string_view> batch(path_queries.begin() + begin, path_queries.begin() + end);
+                for (auto& is_found : find_strings(batch)) {
+                    count_of_found += is_found;
+                }
+            }
+        });
+        DoNotOptimize(count_of_found);
+        ReportRate("bohr_batch_lookup/" + layout, variant, path_queries.size(), batch_nanoseconds, "queries");
+    };
+    auto find_one_by_one = [](auto& trie, auto is_this_string_in_trie) {
+        return [&trie, is_this_string_in_trie](const std::vector<std::string_view>& batch) {
+            std::vector<uint8_t> is_found(batch.size(), 0);
+            for (size_t iteration = 0; iteration < batch.size(); ++iteration) {
+                is_found[iteration] = (trie.*is_this_string_in_trie)(batch[iteration]);
+            }
+            return is_found;
+        };
+    };
+    report_batches("arena", "one_by_one", find_one_by_one(path_dictionary, &Bohr::IsThisStringInBohr));
+    report_batches("arena", "sorted", [&](auto& batch) { return FindStringsInTrie(path_dictionary, batch); });
+    report_batches("arena", "interleaved",
+                   [&](auto& batch) { return FindStringsInTrieInterleaved(path_dictionary, batch); });
+    report_batches("double_array", "one_by_one",
+                   find_one_by_one(frozen_path_dictionary, &DoubleArrayTrie::IsThisStringInTrie));
+    report_batches("double_array", "sorted",
+                   [&](auto& batch) { return FindStringsInTrie(frozen_path_dictionary, batch); });
+    report_batches("double_array", "interleaved",
+                   [&](auto& batch) { return FindStringsInTrieInterleaved(frozen_path_dictionary, batch); });
+
+    std::vector<std::string_view> queries;
+    for (size_t iteration = 0; iteration < query_count; ++iteration) {
+        queries.push_back(words[iteration % words.size()]);
+    }
+    // End to end, inserts included: half of the words are loaded, then readers on 1, 2, 4, ... threads look
+    // up all queries while one writer adds the other half, against one thread doing the same work in turn
+    // on the arena Bohr. The second half adds fewer new nodes than the first, so twice the nodes of the
+    // first half are enough.
+    size_t request_count = words.size() + query_count;
+    size_t max_node_count = 2 * dictionary.GetNodeCount();
+    nanoseconds = MeasureNanoseconds([&]() {
+        Bohr sequential_dictionary(kAlphabetSize, kBeginOfAlphabet);
+        for (size_t iteration = 0; iteration < words.size(); iteration += 2) {
+            sequential_dictionary.AddNewString(words[iteration]);
+        }
+        for (size_t iteration = 1; iteration < words.size(); iteration += 2) {
+            sequential_dictionary.AddNewString(words[iteration]);
+        }
+        for (auto& query : queries) {
+            count_of_found += sequential_dictionary.IsThisStringInBohr(query);
+        }
+    });
+    DoNotOptimize(count_of_found);
+    ReportRate("bohr_concurrent", "sequential", request_count, nanoseconds, "requests");
+    for (uint32_t thread_count = 1; thread_count <= std::thread::hardware_concurrency(); thread_count *= 2) {
+        nanoseconds = MeasureNanoseconds([&]() {
+            ConcurrentBohr concurrent_dictionary(kAlphabetSize, kBeginOfAlphabet, max_node_count);
+            for (size_t iteration = 0; iteration < words.size(); iteration += 2) {
+                concurrent_dictionary.AddNewString(words[iteration]);
+            }
+            std::thread writer([&]() {
+                for (size_t iteration = 1; iteration < words.size(); iteration += 2) {
+                    concurrent_dictionary.AddNewString(words[iteration]);
+                }
+            });
+            for (auto& is_found : FindStringsInBohrParallel(concurrent_dictionary, queries, thread_count)) {
+                count_of_found += is_found;
+            }
+            writer.join();
+        });
+        DoNotOptimize(count_of_found);
+        ReportRate("bohr_concurrent", "threads_" + std::to_string(thread_count), request_count, nanoseconds,
+                   "requests");
+    }
+
+    // End to end through AnswerRequests, parsing and printing included, with the arena Bohr and with freezing,
+    // and with lookups one by one and in batches: first all words and then all lookups; half of the words,
+    // lookups, the other half and lookups again, so words arrive after the freeze; or words and lookups mixed
+    // at random.
+    std::string load_then_query_requests;
+    std::string reload_requests;
+    std::string mixed_requests;
+    for (size_t iteration = 0; iteration < words.size(); iteration += 2) {
+        load_then_query_requests.append("+ ").append(words[iteration]).append("\n");
+    }
+    for (size_t half = 0; half < 2; ++half) {
+        for (size_t iteration = half; iteration < words.size(); iteration += 2) {
+            reload_requests.append("+ ").append(words[iteration]).append("\n");
+        }
+        for (size_t iteration = 0; iteration < words.size() / 2; ++iteration) {
+            reload_requests.append("? ").append(words[generator() % words.size()]).append("\n");
+        }
+    }
+    for (size_t iteration = 0; iteration < words.size(); ++iteration) {
+        load_then_query_requests.append("? ").append(words[generator() % words.size()]).append("\n");
+        mixed_requests.append(generator() % 2 == 0 ? "+ " : "? ").append(words[iteration]).append("\n");
+    }
+    std::string query_flood_requests;
+    for (size_t iteration = 0; iteration < words.size(); iteration += 16) {
+        query_flood_requests.append("+ ").append(words[iteration]).append("\n");
+    }
+    for (size_t iteration = 0; iteration < 4 * words.size(); ++iteration) {
+        query_flood_requests.append("? ").append(words[generator() % words.size()]).append("\n");
+    }
+    for (auto& [input_name, requests] : {std::make_pair("load_query", &load_then_query_requests),
+                                         std::make_pair("query_flood", &query_flood_requests),
+                                         std::make_pair("reload", &reload_requests),
+                                         std::make_pair("mixed", &mixed_requests)}) {
+        requests->append("#\n");
+        size_t request_count = std::count(requests->begin(), requests->end(), '\n');
+        FILE* file = std::tmpfile();
+        std::fwrite(requests->data(), 1, requests->size(), file);
+        std::fflush(file);
+        int null_descriptor = open("/dev/null", O_WRONLY);
+        for (auto& is_freezing : {false, true}) {
+            for (auto& lookup_batch_size : {size_t{1}, kLookupBatchSize}) {
+                lseek(fileno(file), 0, SEEK_SET);
+                nanoseconds = MeasureNanoseconds([&]() {
+                    FastReader input(fileno(file));
+                    FastWriter output(null_descriptor);
+                    AnswerRequests(input, output, lookup_batch_size, is_freezing);
+                });
+                std::string name = is_freezing ? "bohr_requests/frozen" : "bohr_requests/arena";
+                name += lookup_batch_size == 1 ? "/one_by_one" : "/batched";
+                ReportRate(name, input_name, request_count, nanoseconds, "requests");
+            }
+        }
+        close(null_descriptor);
+        std::fclose(file);
+    }
+
+    RunScalingBenchmark(
+        "bohr_add_and_find", "abcdefghijklmnopqrstuvwxyz", 1000 * 1000,
+        [](const std::string& str) { return GenerateWords(str, 4); },
+        [](const std::vector<std::string>& words) -> uint64_t {
+            Bohr dictionary(kAlphabetSize, kBeginOfAlphabet);
+            for (size_t iteration = 0; iteration < words.size(); iteration += 2) {
+                dictionary.AddNewString(words[iteration]);
+            }
+            uint64_t count_of_found = 0;
+            for (auto& word : words) {
+                count_of_found += dictionary.IsThisStringInBohr(word);
+            }
+            return count_of_found;
+        });
+    return 0;
+}
+#endif
+
+int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+    AnswerRequests(input, output);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,13 +1,24 @@
 #include <algorithm>
-#include <iostream>
 #include <climits>
 #include <memory>
 #include <string>
 #include <vector>
 #include <map>
 
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
 class Trie {
+private:
+    struct TrieNode;
+
 public:
+    // A node reached by descending one edge at a time; nullptr once the prefix is not in the trie.
+    using Cursor = const TrieNode*;
+
     explicit Trie(const char first, const size_t size_of_abc) {
         root_ = std::make_shared<TrieNode>('#', size_of_abc);
         k_code_of_begining_ = first;
@@ -48,19 +59,39 @@ public:
     }
 
     size_t CountSubstr(const std::string& str) const {
-        std::shared_ptr<TrieNode> current_node = root_;
+        Cursor cursor = Root();
 
         for (auto symbol : str) {
-            size_t symbol_code = symbol - k_code_of_begining_;
+            cursor = Child(cursor, symbol);
+        }
 
-            current_node = current_node->next_symbols_[symbol];
+        return Count(cursor);
+    }
 
-            if (current_node == nullptr) {
-                return 0;
-            }
+    Cursor Root() const {
+        return root_.get();
+    }
+
+    Cursor Child(const Cursor cursor, const char symbol) const {
+        if (cursor == nullptr) {
+            return nullptr;
         }
 
-        return current_node->elements_in_;
+        auto next = cursor->next_symbols_.find(symbol);
+        if (next == cursor->next_symbols_.end()) {
+            return nullptr;
+        }
+
+        return next->second.get();
+    }
+
+    // Number of inserted strings that start with the prefix of the cursor.
+    size_t Count(const Cursor cursor) const {
+        if (cursor == nullptr) {
+            return 0;
+        }
+
+        return cursor->elements_in_;
     }
 
 private:
@@ -82,32 +113,29 @@ private:
     size_t k_size_of_abc_ = 0;
 };
 
-size_t CountMinCost(const std::vector<size_t>& costs, const Trie& trie, const size_t len_num, const size_t len_abc,
-                    const char first, const std::string& str, std::string& min_cost_str) {
+// str is the prefix of the cursor. It is extended and restored in place while the search descends one edge per
+// level, so no candidate is copied or walked again from the root.
+size_t CountMinCostFromCursor(const std::vector<size_t>& costs, const Trie& trie, const Trie::Cursor cursor,
+                              const size_t len_num, const size_t len_abc, const char first, std::string& str,
+                              std::string& min_cost_str) {
     size_t min_cost = INT_MAX;
     size_t current_len = str.length();
     char current_letter = first;
-    // char best_letter = 0;
     std::string best_word;
 
     for (size_t i = 0; i < len_abc; ++i) {
-        std::string str_to_check = str + current_letter;
-        size_t counter = trie.CountSubstr(str_to_check);
+        Trie::Cursor next_cursor = trie.Child(cursor, current_letter);
+        size_t counter = trie.Count(next_cursor);
 
         if (counter == 0) {
-            min_cost_str = str_to_check;
-            if (min_cost_str.length() > len_num) {
-                min_cost_str = min_cost_str.substr(0, len_num);
-            }
+            str.push_back(current_letter);
+            min_cost_str.assign(str, 0, len_num);
+            str.pop_back();
 
             for (size_t j = current_len + 1; j < len_num; ++j) {
                 min_cost_str += current_letter;
             }
 
-            // std::cout << "update best_word for " << str_to_check << " to " << best_word << std::endl;
-
-            // best_letter = current_letter;
-            min_cost = 0;
             return 0;
         }
 
@@ -116,12 +144,14 @@ size_t CountMinCost(const std::vector<size_t>& costs, const Trie& trie, const si
             delta = counter * costs[current_len - 1];
         }
 
-        size_t sons_min_cost = CountMinCost(costs, trie, len_num, len_abc, first, str_to_check, best_word);
+        str.push_back(current_letter);
+        size_t sons_min_cost =
+            CountMinCostFromCursor(costs, trie, next_cursor, len_num, len_abc, first, str, best_word);
+        str.pop_back();
+
         if (counter * costs[current_len] - delta + sons_min_cost < min_cost) {
             min_cost = counter * costs[current_len] - delta + sons_min_cost;
-            // best_letter = current_letter;
             min_cost_str = best_word;
-            // std::cout << "Update min_cost for " << str_to_check << " to " << min_cost << std::endl;
         }
 
         ++current_letter;
@@ -130,21 +160,96 @@ size_t CountMinCost(const std::vector<size_t>& costs, const Trie& trie, const si
     return min_cost;
 }
 
+size_t CountMinCost(const std::vector<size_t>& costs, const Trie& trie, const size_t len_num, const size_t len_abc,
+                    const char first, const std::string& str, std::string& min_cost_str) {
+    Trie::Cursor cursor = trie.Root();
+    for (auto symbol : str) {
+        cursor = trie.Child(cursor, symbol);
+    }
+
+    std::string buffer = str;
+    buffer.reserve(len_num + 1);
+    return CountMinCostFromCursor(costs, trie, cursor, len_num, len_abc, first, buffer, min_cost_str);
+}
+
+#ifdef BENCHMARK
+int RunBenchmark() {
+    const size_t len_num = 8;
+    const size_t len_abc = 10;
+
+    RunScalingBenchmark(
+        "count_min_cost", "abcdefghijklmnopqrstuvwxyz", 1000 * 1000,
+        [](const std::string& str) {
+            std::vector<std::string> tickets;
+            auto digits = ConvertToDigits(str, len_abc);
+            for (size_t position = 0; position + len_num <= digits.size(); position += len_num) {
+                tickets.push_back(digits.substr(position, len_num));
+            }
+            return tickets;
+        },
+        [](const std::vector<std::string>& tickets) -> uint64_t {
+            Trie trie('0', len_abc);
+            for (auto& ticket : tickets) {
+                trie.InsertStr(ticket);
+            }
+            std::vector<size_t> costs(len_num);
+            for (size_t iteration = 0; iteration < len_num; ++iteration) {
+                costs[iteration] = len_num - iteration;
+            }
+            std::string min_cost_str;
+            return CountMinCost(costs, trie, len_num, len_abc, '0', "", min_cost_str);
+        });
+
+    // Long binary tickets: a dense head of a dozen digits and a tail of zeros, which the search has to
+    // descend to the end for every ticket.
+    const size_t long_len_num = 1000;
+    const size_t head_len = 12;
+
+    RunScalingBenchmark(
+        "count_min_cost_long", "abcdefghijklmnopqrstuvwxyz", 100 * 1000,
+        [](const std::string& str) {
+            std::vector<std::string> tickets;
+            auto digits = ConvertToDigits(str, 2);
+            for (size_t position = 0; position + head_len <= digits.size(); position += head_len) {
+                tickets.push_back(digits.substr(position, head_len) + std::string(long_len_num - head_len, '0'));
+            }
+            return tickets;
+        },
+        [](const std::vector<std::string>& tickets) -> uint64_t {
+            Trie trie('0', 2);
+            for (auto& ticket : tickets) {
+                trie.InsertStr(ticket);
+            }
+            std::vector<size_t> costs(long_len_num);
+            for (size_t iteration = 0; iteration < long_len_num; ++iteration) {
+                costs[iteration] = iteration + 1;
+            }
+            std::string min_cost_str;
+            return CountMinCost(costs, trie, long_len_num, 2, '0', "", min_cost_str);
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::ios_base::sync_with_stdio(false);
-    std::cin.tie(nullptr);
-    std::cout.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     size_t members = 0;
     size_t len_num = 0;
     size_t len_abc = 0;
 
-    std::cin >> members >> len_num >> len_abc;
+    input >> members >> len_num >> len_abc;
 
     std::vector<size_t> costs;
 
     for (size_t i = 0; i < len_num; ++i) {
         size_t cost = 0;
-        std::cin >> cost;
+        input >> cost;
 
         costs.push_back(cost);
     }
@@ -153,7 +258,7 @@ int main() {
 
     for (size_t i = 0; i < members; ++i) {
         std::string ticket;
-        std::cin >> ticket;
+        input >> ticket;
 
         trie.InsertStr(ticket);
     }
@@ -161,8 +266,8 @@ int main() {
     std::string min_cost_str;
     std::string empty_str;
     size_t min_cost = CountMinCost(costs, trie, len_num, len_abc, '0', empty_str, min_cost_str);
-    std::cout << min_cost_str << std::endl;
-    std::cout << min_cost << std::endl;
+    output << min_cost_str << '\n';
+    output << min_cost << '\n';
 
     return 0;
 }
\ No newline at end of file
@@ -1,4 +1,3 @@
-#include <iostream>
 #include <cstdlib>
 #include <string>
 #include <vector>
@@ -6,6 +5,12 @@
 #include <cmath>
 #include <map>
 
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
 const uint64_t kAlphabetSize = 10;
 const char kBeginOfAlphabet = '0';
 
@@ -123,26 +128,54 @@ public:
     }
 };
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    const uint64_t max_length = 8;
+
+    RunScalingBenchmark(
+        "number_of_free_codes", "abcdefghijklmnopqrstuvwxyz", 1000 * 1000,
+        [max_length](const std::string& str) {
+            std::map<NameT, CodeT> cities;
+            auto digits = ConvertToDigits(str, kAlphabetSize);
+            for (size_t position = 0; position + max_length <= digits.size(); position += max_length) {
+                cities["city" + std::to_string(position)] = digits.substr(position, 1 + position % max_length);
+            }
+            return cities;
+        },
+        [max_length](const std::map<NameT, CodeT>& cities) -> uint64_t {
+            Bohr dictionary(kAlphabetSize, kBeginOfAlphabet);
+            for (auto& city : cities) {
+                dictionary.AddNewString(city.second);
+            }
+            return dictionary.GetNumberOfFreeCodes(cities, max_length).size();
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
-    std::cout.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
 
     uint64_t string_count = 0;
-    std::cin >> string_count;
+    input >> string_count;
 
     uint64_t string_length = 0;
-    std::cin >> string_length;
+    input >> string_length;
 
     Bohr dictionary(kAlphabetSize, kBeginOfAlphabet);
 
     std::map<NameT, CodeT> cities;
     for (uint64_t iteration = 0; iteration < string_count; ++iteration) {
         CodeT code;
-        std::cin >> code;
+        input >> code;
 
         NameT name;
-        std::cin >> name;
+        input >> name;
 
         cities[name] = code;
         dictionary.AddNewString(code);
@@ -150,7 +183,7 @@ int main() {
 
     auto codes = dictionary.GetNumberOfFreeCodes(cities, string_length);
     for (auto& info : codes) {
-        std::cout << info.first << ' ' << info.second << '\n';
+        output << info.first << ' ' << info.second << '\n';
     }
 
     return 0;
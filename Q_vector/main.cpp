@@ -1,10 +1,16 @@
-#include <iostream>
 #include <string>
 #include <vector>
 #include <memory>
 #include <map>
 #include <unordered_map>
 
+#include "../benchmark/counters.h"
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/aho_corasick.h"
+#endif
+
 using DictionaryT = std::unordered_map<std::string, std::vector<uint32_t>>;
 using PatternT = std::vector<std::string>;
 
@@ -97,10 +103,12 @@ public:
     }
 
     uint32_t GetTransitions(const uint32_t& current_vertex, const char& symbol) {
+        COUNTER_INCREMENT("get_transitions.calls");
         uint32_t position = symbol - symbol_of_beginning_of_alphabet_;
         if (bohr_[current_vertex].auto_transition[position] != kInfinity) {
             return bohr_[current_vertex].auto_transition[position];
         }
+        COUNTER_INCREMENT("get_transitions.misses");
 
         if (bohr_[current_vertex].next_vertex[position] != kInfinity) {
             bohr_[current_vertex].auto_transition[position] = bohr_[current_vertex].next_vertex[position];
@@ -149,22 +157,23 @@ public:
     }
 
     void CheckEndSuffixLink(const uint32_t& current_vertex, const uint32_t& iteration, DictionaryT& dictionary) {
+        uint32_t chain_length = 0;
         for (auto new_vertex = current_vertex; new_vertex != 0; new_vertex = GetEndSuffixLink(new_vertex)) {
+            ++chain_length;
             if (bohr_[new_vertex].count_string_that_end_at_this_vertex > 0) {
                 auto current_string = pattern_[bohr_[new_vertex].pattern_number];
                 dictionary[current_string].push_back(iteration - current_string.length() + 1);
             }
         }
+        COUNTER_ADD("check_end_suffix_link.steps", chain_length);
+        COUNTER_MAX("check_end_suffix_link.max_chain", chain_length);
     }
 
-    DictionaryT FindAllOccurrencesOfPatternInText(const std::string& text, const PatternT& pattern) {
-        for (uint32_t iteration = 0; iteration < pattern.size(); ++iteration) {
-            AddNewString(pattern[iteration]);
-        }
-
+    // Scans text for every pattern added so far; each of them gets an entry, even without occurrences.
+    DictionaryT FindAllOccurrencesInText(const std::string& text) {
         DictionaryT dictionary;
-        for (uint32_t iteration = 0; iteration < pattern.size(); ++iteration) {
-            dictionary[pattern[iteration]] = {};
+        for (auto& str : pattern_) {
+            dictionary[str] = {};
         }
 
         uint32_t current_vertex = 0;
@@ -175,34 +184,70 @@ public:
 
         return dictionary;
     }
+
+    DictionaryT FindAllOccurrencesOfPatternInText(const std::string& text, const PatternT& pattern) {
+        for (uint32_t iteration = 0; iteration < pattern.size(); ++iteration) {
+            AddNewString(pattern[iteration]);
+        }
+        return FindAllOccurrencesInText(text);
+    }
 };
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunAhoCorasickComparison("vector", []() { return Bohr(kAlphabetSize, kBeginOfAlphabet); });
+
+    RunScalingBenchmark(
+        "aho_corasick", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize,
+        [](std::string text) {
+            PatternT pattern;
+            for (size_t iteration = 1; iteration <= 16; ++iteration) {
+                pattern.push_back(text.substr(text.size() * iteration / 17, 8));
+            }
+            return std::make_pair(std::move(text), std::move(pattern));
+        },
+        [](const std::pair<std::string, PatternT>& input) -> uint64_t {
+            Bohr bohr(kAlphabetSize, kBeginOfAlphabet);
+            auto dictionary = bohr.FindAllOccurrencesOfPatternInText(input.first, input.second);
+            uint64_t count_of_occurrence = 0;
+            for (auto& occurrences : dictionary) {
+                count_of_occurrence += occurrences.second.size();
+            }
+            return count_of_occurrence;
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
-    std::cout.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
 
     std::string text;
-    std::cin >> text;
+    input >> text;
 
     Bohr bohr(kAlphabetSize, kBeginOfAlphabet);
 
     uint32_t count_of_request = 0;
-    std::cin >> count_of_request;
+    input >> count_of_request;
 
     PatternT pattern(count_of_request);
     for (uint32_t iteration = 0; iteration < count_of_request; ++iteration) {
-        std::cin >> pattern[iteration];
+        input >> pattern[iteration];
     }
 
     auto dictionary = bohr.FindAllOccurrencesOfPatternInText(text, pattern);
     for (uint32_t iteration = 0; iteration < pattern.size(); ++iteration) {
         auto output_vector = dictionary[pattern[iteration]];
-        std::cout << output_vector.size() << ' ';
+        output << output_vector.size() << ' ';
         for (auto& elem : output_vector) {
-            std::cout << elem << ' ';
+            output << elem << ' ';
         }
-        std::cout << std::endl;
+        output << '\n';
     }
 
     return 0;
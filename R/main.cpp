@@ -1,10 +1,15 @@
-#include <iostream>
 #include <string>
 #include <vector>
 #include <memory>
 #include <map>
 #include <unordered_map>
 
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
 using DictionaryT = std::unordered_map<std::string, std::vector<uint32_t>>;
 using PatternT = std::vector<std::string>;
 
@@ -168,27 +173,54 @@ struct Segment {
     }
 };
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "aho_corasick", "abcdefghijklmnopqrstuvwxyz", kBenchmarkMaxSize,
+        [](std::string text) {
+            PatternT pattern;
+            for (size_t iteration = 1; iteration <= 16; ++iteration) {
+                pattern.push_back(text.substr(text.size() * iteration / 17, 8));
+            }
+            return std::make_pair(std::move(text), std::move(pattern));
+        },
+        [](const std::pair<std::string, PatternT>& input) -> uint64_t {
+            Bohr bohr;
+            auto dictionary = bohr.FindAllOccurrencesOfPatternInText(input.first, input.second);
+            uint64_t count_of_occurrence = 0;
+            for (auto& occurrences : dictionary) {
+                count_of_occurrence += occurrences.second.size();
+            }
+            return count_of_occurrence;
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
-    std::cout.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
 
     std::string text;
-    std::cin >> text;
+    input >> text;
 
     Bohr bohr;
 
     uint32_t count_of_request = 0;
-    std::cin >> count_of_request;
+    input >> count_of_request;
 
     std::vector<Segment> segments;
     PatternT pattern(count_of_request);
     for (uint32_t iteration = 0; iteration < count_of_request; ++iteration) {
         uint32_t begin = 0;
         uint32_t end = 0;
-        std::cin >> begin >> end;
+        input >> begin >> end;
         segments.emplace_back(begin, end);
-        std::cin >> pattern[iteration];
+        input >> pattern[iteration];
     }
 
     std::string answer;
@@ -210,7 +242,7 @@ int main() {
         }
     }
 
-    std::cout << answer << std::endl;
+    output << answer << '\n';
 
     return 0;
 }
\ No newline at end of file
@@ -1,7 +1,13 @@
-#include <iostream>
 #include <string>
 #include <vector>
 
+#include "../benchmark/counters.h"
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
 const uint64_t kInfinity = 1000 * 1000 * 1000 * 1LL;
 
 class SuffixTree {
@@ -34,6 +40,7 @@ public:
     }
 
     void AddSymbol(const char& symbol) {
+        COUNTER_INCREMENT("add_symbol.calls");
         uint64_t position = symbol - 'a';
 
         current_length_ += 1;
@@ -44,6 +51,7 @@ public:
         auto current_vertex = last_;
 
         while (current_vertex != kInfinity && tree_[current_vertex].next_vertex[position] == kInfinity) {
+            COUNTER_INCREMENT("add_symbol.link_steps");
             tree_[current_vertex].next_vertex[position] = length;
             current_vertex = tree_[current_vertex].link;
         }
@@ -63,12 +71,14 @@ public:
 
         ++current_length_;
         auto copy = current_length_;
+        COUNTER_INCREMENT("add_symbol.clones");
 
         tree_[copy].length = tree_[current_vertex].length + 1;
         tree_[copy].next_vertex = tree_[new_vertex].next_vertex;
         tree_[copy].link = tree_[new_vertex].link;
 
         while (current_vertex != kInfinity && tree_[current_vertex].next_vertex[position] == new_vertex) {
+            COUNTER_INCREMENT("add_symbol.redirect_steps");
             tree_[current_vertex].next_vertex[position] = copy;
             current_vertex = tree_[current_vertex].link;
         }
@@ -79,28 +89,46 @@ public:
         last_ = length;
     }
 
-    void FindNumberOfDifferentSubstringsForEachPrefixOfString(const std::string& str) {
+    void FindNumberOfDifferentSubstringsForEachPrefixOfString(const std::string& str, FastWriter& output) {
         uint64_t current_number = 0;
         for (uint64_t iteration = 0; iteration < str.length(); ++iteration) {
             AddSymbol(str[iteration]);
             auto suffix_link = tree_[tree_[last_].link];
             current_number += tree_[last_].length - suffix_link.length;
-            printf("%lu\n", current_number);
+            output << current_number << '\n';
         }
     }
 };
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "suffix_automaton_add_symbol", "abcdefghijklmnopqrstuvwxyz", 1000 * 1000, [](std::string str) { return str; },
+        [](const std::string& str) -> uint64_t {
+            SuffixTree tree(str.length());
+            for (auto& symbol : str) {
+                tree.AddSymbol(symbol);
+            }
+            return str.length();
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
-    std::cout.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
 
     std::string str;
-    std::cin >> str;
+    input >> str;
 
     SuffixTree tree(str.length());
 
-    tree.FindNumberOfDifferentSubstringsForEachPrefixOfString(str);
+    tree.FindNumberOfDifferentSubstringsForEachPrefixOfString(str, output);
 
     return 0;
 }
@@ -1,8 +1,13 @@
-#include <iostream>
 #include <cstdio>
 #include <cstdlib>
 #include <vector>
 #include <string>
+
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
  
 const size_t    SYMBOLS_AMOUNT  = 27;
 const char      ALPHABET_OFFSET = 'a';
@@ -73,10 +78,48 @@ void suffix_tree_add(std::vector<Suffix_tree_node> &tree, const std::vector<char
 void renumber(std::vector<Suffix_tree_node> &tree, int64_t vertex, int64_t *number);
 void print_tree(std::vector<Suffix_tree_node> &tree, int64_t vertex);
  
+#ifdef BENCHMARK
+int run_benchmark()
+{
+    RunScalingBenchmark("suffix_tree_add", "abcdefghijklmnopqrstuvwxyz", 1000 * 1000,
+        [](const std::string &str)
+        {
+            std::vector<char> string;
+            for (auto &symbol : str)
+            {
+                string.push_back(symbol - ALPHABET_OFFSET + 1);
+            }
+            string.push_back(0);
+            return string;
+        },
+        [](const std::vector<char> &string) -> uint64_t
+        {
+            std::vector<Suffix_tree_node> tree;
+            Current_state state = { 0, 0 };
+
+            tree.push_back(Suffix_tree_node());
+            int64_t last = 0;
+            for (int64_t i = 0; i < static_cast<int64_t>(string.size()); ++i)
+            {
+                suffix_tree_add(tree, string, state, i, last);
+            }
+            return tree.size();
+        });
+    return 0;
+}
+#endif
+
 int main()
 {
+#ifdef BENCHMARK
+    return run_benchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     std::string str;
-    std::cin >> str;
+    input >> str;
 
     std::vector<char> string;
     for (auto &symbol : str)
@@ -97,7 +140,7 @@ int main()
         suffix_tree_add(tree, string, state, i, last);
         auto suffix_link = tree[tree[last].link];
         count += (tree[last].length() - suffix_link.length() + 1);
-        std::cout << count << '\n';
+        output << count << '\n';
     }
 
     return 0;
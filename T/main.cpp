@@ -1,9 +1,14 @@
-#include <iostream>
 #include <string>
 #include <vector>
 #include <map>
 #include <stack>
 
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
 class SuffixArray {
 private:
     std::string str_;
@@ -206,19 +211,35 @@ private:
     }
 };
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "suffix_array_refrain", "abcdefghijklmnopqrstuvwxyz", 10 * 1000 * 1000,
+        [](const std::string& str) { return str + "$"; },
+        [](const std::string& str) -> uint64_t {
+            SuffixArray suffix_array(str);
+            return suffix_array.GetRefrain()[0];
+        });
+    return 0;
+}
+#endif
+
 int main() {
-    std::ios::sync_with_stdio(false);
-    std::cin.tie(nullptr);
-    std::cout.tie(nullptr);
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
 
     int64_t sequence_size = 0;
     int64_t range_of_numbers = 0;
 
-    std::cin >> sequence_size >> range_of_numbers;
+    input >> sequence_size >> range_of_numbers;
 
     std::vector<int64_t> sequence(sequence_size);
     for (int64_t iteration = 0; iteration < sequence_size; ++iteration) {
-        std::cin >> sequence[iteration];
+        input >> sequence[iteration];
     }
 
     std::string result_str;
@@ -229,12 +250,12 @@ int main() {
     SuffixArray suffix_array(result_str + "$");
 
     auto refrain = suffix_array.GetRefrain();
-    std::cout << refrain[0] << std::endl;
-    std::cout << refrain.size() - 1 << std::endl;
+    output << refrain[0] << '\n';
+    output << refrain.size() - 1 << '\n';
     for (uint64_t iteration = 1; iteration < refrain.size(); ++iteration) {
-        std::cout << refrain[iteration] << ' ';
+        output << refrain[iteration] << ' ';
     }
-    std::cout << std::endl;
+    output << '\n';
 
     return 0;
 }
@@ -1,7 +1,12 @@
-#include <iostream>
 #include <vector>
 #include <string>
 
+#include "../io/fast_io.h"
+
+#ifdef BENCHMARK
+#include "../benchmark/benchmark.h"
+#endif
+
 const uint64_t kInfinity = 1000 * 1000 * 1000 * 1LL;
 
 class SuffixTree {
@@ -190,15 +195,15 @@ public:
         }
     }
 
-    void PrintTree() {
-        std::cout << tree_.size() << '\n';
+    void PrintTree(FastWriter& output) {
+        output << tree_.size() << '\n';
 
         uint64_t current_number = 0;
         Renumber(0, current_number);
-        PrintSuffixTree(0);
+        PrintSuffixTree(output, 0);
     }
 
-    void PrintSuffixTree(const uint64_t& current_vertex) {
+    void PrintSuffixTree(FastWriter& output, const uint64_t& current_vertex) {
         for (uint64_t iteration = 0; iteration < 27; ++iteration) {
             uint64_t next_vertex = tree_[current_vertex].next_vertex[iteration];
             if (next_vertex != kInfinity) {
@@ -206,9 +211,9 @@ public:
                 uint64_t second = 0;
                 uint64_t third = tree_[next_vertex].begin;
                 uint64_t fourth = tree_[next_vertex].end;
-                std::cout << first << ' ' << second << ' ' << third << ' ' << fourth << '\n';
+                output << first << ' ' << second << ' ' << third << ' ' << fourth << '\n';
 
-                PrintSuffixTree(next_vertex);
+                PrintSuffixTree(output, next_vertex);
             }
         }
     }
@@ -226,12 +231,39 @@ public:
 
 };
 
+#ifdef BENCHMARK
+int RunBenchmark() {
+    RunScalingBenchmark(
+        "ukkonen_suffix_tree", "abcdefghijklmnopqrstuvwxyz", 1000 * 1000,
+        [](const std::string& str) {
+            std::vector<uint64_t> symbols;
+            for (auto& symbol : str) {
+                symbols.push_back(symbol - 'a' + 1);
+            }
+            symbols.push_back(0);
+            return symbols;
+        },
+        [](const std::vector<uint64_t>& symbols) -> uint64_t {
+            SuffixTree tree(symbols);
+            return tree.tree_.size();
+        });
+    return 0;
+}
+#endif
+
 int main() {
+#ifdef BENCHMARK
+    return RunBenchmark();
+#endif
+
+    FastReader input;
+    FastWriter output;
+
     std::string first_str;
     std::string second_str;
 
-    std::cin >> first_str;
-    std::cin >> second_str;
+    input >> first_str;
+    input >> second_str;
 
     std::vector<uint64_t> first;
     std::vector<uint64_t> second;
@@ -247,8 +279,8 @@ int main() {
     SuffixTree first_tree(first);
     SuffixTree second_tree(second);
 
-    first_tree.PrintTree();
-    second_tree.PrintTree();
+    first_tree.PrintTree(output);
+    second_tree.PrintTree(output);
 
     return 0;
 }
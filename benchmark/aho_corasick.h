@@ -0,0 +1,133 @@
+#pragma once
+
+#include "benchmark.h"
+
+const size_t kAhoCorasickTextSize = 8 * 1000 * 1000;
+const size_t kAhoCorasickMinPatterns = 10;
+const size_t kAhoCorasickMaxPatterns = 1000 * 1000;
+const uint64_t kAhoCorasickSeed = 2024;
+
+// Patterns of 4 to 16 symbols over alphabet: even ones are cut from text, so they occur, odd ones are
+// random and mostly do not. The seed depends only on count, so every layout gets the same set.
+inline std::vector<std::string> GenerateAhoCorasickPatterns(const std::string& text, const size_t& count,
+                                                            const std::string& alphabet) {
+    std::mt19937_64 generator(kAhoCorasickSeed + count);
+    std::vector<std::string> pattern(count);
+    for (size_t iteration = 0; iteration < count; ++iteration) {
+        size_t length = 4 + iteration % 13;
+        if (iteration % 2 == 0) {
+            pattern[iteration] = text.substr(generator() % (text.size() - length), length);
+        } else {
+            pattern[iteration] = GenerateRandomString(length, alphabet, generator());
+        }
+    }
+    return pattern;
+}
+
+// Order-sensitive FNV-1a hash of the occurrences of every pattern, taken in pattern order, so two
+// layouts agree exactly when they would print the same answer.
+template <class DictionaryT>
+uint64_t GetDictionaryChecksum(const DictionaryT& dictionary, const std::vector<std::string>& pattern) {
+    uint64_t checksum = 14695981039346656037ULL;
+    auto mix = [&checksum](const uint64_t& value) { checksum = (checksum ^ value) * 1099511628211ULL; };
+    for (auto& str : pattern) {
+        auto it = dictionary.find(str);
+        if (it == dictionary.end()) {
+            mix(~0ULL);
+            continue;
+        }
+        mix(it->second.size());
+        for (auto& elem : it->second) {
+            mix(elem);
+        }
+    }
+    return checksum;
+}
+
+struct AhoCorasickMeasurement {
+    double build_nanoseconds = 0;
+    double search_nanoseconds = 0;
+    long build_kilobytes = 0;
+    long peak_kilobytes = 0;
+    uint64_t count_of_occurrence = 0;
+    uint64_t checksum = 0;
+};
+
+// Head-to-head run of one Aho-Corasick layout: for 10, 100, ... up to 10^6 patterns (and up to the
+// BENCHMARK_MAX_PATTERNS environment variable) it builds make_bohr() from the shared pattern set, scans
+// the shared texts, and reports build time, memory taken by the build, text MB/s, matches/s, peak RSS
+// and a checksum of the answer. Each measurement runs in a forked child, like RunScalingBenchmark, so a
+// layout that runs out of memory only ends its own series; peak RSS and build memory count only what
+// the child took on top of the pages it inherited.
+template <class MakeBohr>
+void RunAhoCorasickComparison(const std::string& layout, MakeBohr make_bohr) {
+    size_t max_count = kAhoCorasickMaxPatterns;
+    if (const char* limit = std::getenv("BENCHMARK_MAX_PATTERNS")) {
+        max_count = std::min<size_t>(max_count, std::strtoull(limit, nullptr, 10));
+    }
+
+    // Few matches over the whole alphabet, many over four letters.
+    std::vector<std::pair<std::string, std::string>> texts = {{"letters", "abcdefghijklmnopqrstuvwxyz"},
+                                                              {"dna", "acgt"}};
+    std::string name = "aho_corasick/" + layout;
+    for (auto& [input, alphabet] : texts) {
+        for (size_t count = kAhoCorasickMinPatterns; count <= max_count; count *= 10) {
+            int channel[2];
+            if (pipe(channel) != 0) {
+                return;
+            }
+            std::cout.flush();
+            pid_t child = fork();
+            if (child == 0) {
+                close(channel[0]);
+                long kilobytes_at_fork = ResetPeakKilobytes();
+                auto text = GenerateRandomString(kAhoCorasickTextSize, alphabet, kAhoCorasickSeed);
+                auto pattern = GenerateAhoCorasickPatterns(text, count, alphabet);
+
+                AhoCorasickMeasurement measurement;
+                long kilobytes_before_build = GetPeakKilobytes();
+
+                auto bohr = make_bohr();
+                measurement.build_nanoseconds = MeasureNanoseconds([&]() {
+                    for (auto& str : pattern) {
+                        bohr.AddNewString(str);
+                    }
+                });
+                measurement.build_kilobytes = GetPeakKilobytes() - kilobytes_before_build;
+
+                decltype(bohr.FindAllOccurrencesInText(text)) dictionary;
+                measurement.search_nanoseconds =
+                    MeasureNanoseconds([&]() { dictionary = bohr.FindAllOccurrencesInText(text); });
+                for (auto& occurrences : dictionary) {
+                    measurement.count_of_occurrence += occurrences.second.size();
+                }
+                measurement.checksum = GetDictionaryChecksum(dictionary, pattern);
+                measurement.peak_kilobytes = GetPeakKilobytes() - kilobytes_at_fork;
+
+                bool is_written = write(channel[1], &measurement, sizeof(measurement)) == sizeof(measurement);
+                _exit(is_written ? 0 : 1);
+            }
+            close(channel[1]);
+            AhoCorasickMeasurement measurement;
+            bool is_read = read(channel[0], &measurement, sizeof(measurement)) == sizeof(measurement);
+            close(channel[0]);
+
+            int status = 0;
+            waitpid(child, &status, 0);
+            std::cout << std::left << std::setw(24) << name << std::setw(12) << input << std::right
+                      << std::setw(9) << count;
+            if (!is_read || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cout << "  failed" << std::endl;
+                break;
+            }
+
+            double search_seconds = measurement.search_nanoseconds / 1e9;
+            std::cout << std::fixed << std::setprecision(1) << std::setw(10) << measurement.build_nanoseconds / 1e6
+                      << " ms build" << std::setw(8) << measurement.build_kilobytes / 1024 << " MB build"
+                      << std::setw(9) << kAhoCorasickTextSize / 1e6 / search_seconds << " MB/s" << std::setw(12)
+                      << std::setprecision(0) << measurement.count_of_occurrence / search_seconds << " matches/s"
+                      << std::setw(7) << measurement.peak_kilobytes / 1024 << " MB peak  " << std::hex << std::setw(16)
+                      << std::setfill('0') << measurement.checksum << std::setfill(' ') << std::dec << std::endl;
+        }
+    }
+}
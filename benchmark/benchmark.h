@@ -0,0 +1,324 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+const size_t kBenchmarkMinSize = 1000;
+const size_t kBenchmarkMaxSize = 100 * 1000 * 1000;
+const double kBenchmarkMaxProjectedNanoseconds = 60e9;
+const size_t kBenchmarkExponentMinSize = 10 * 1000;
+
+inline std::string GenerateRandomString(const size_t& size, const std::string& alphabet, const uint64_t& seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<size_t> distribution(0, alphabet.size() - 1);
+    std::string str(size, 0);
+    for (auto& symbol : str) {
+        symbol = alphabet[distribution(generator)];
+    }
+    return str;
+}
+
+inline std::string GeneratePeriodicString(const size_t& size, const std::string& period) {
+    std::string str(size, 0);
+    for (size_t iteration = 0; iteration < size; ++iteration) {
+        str[iteration] = period[iteration % period.size()];
+    }
+    return str;
+}
+
+// Prefix of the infinite Fibonacci word abaababaabaab..., the classic worst case for failure links.
+inline std::string GenerateFibonacciString(const size_t& size, const char& first = 'a', const char& second = 'b') {
+    std::string previous(1, first);
+    std::string current{first, second};
+    while (current.size() < size) {
+        auto next = current + previous;
+        previous = std::move(current);
+        current = std::move(next);
+    }
+    current.resize(size);
+    return current;
+}
+
+// Prefix of the Thue-Morse word: symbol i is decided by the parity of the number of ones in i.
+inline std::string GenerateThueMorseString(const size_t& size, const char& first = 'a', const char& second = 'b') {
+    std::string str(size, first);
+    for (size_t iteration = 0; iteration < size; ++iteration) {
+        if (__builtin_popcountll(iteration) % 2 == 1) {
+            str[iteration] = second;
+        }
+    }
+    return str;
+}
+
+// Prefix of the de Bruijn sequence of the smallest order whose length reaches size, built by
+// concatenating Lyndon words in lexicographic order.
+inline std::string GenerateDeBruijnString(const size_t& size, const std::string& alphabet) {
+    size_t order = 1;
+    for (size_t length = alphabet.size(); length < size; length *= alphabet.size()) {
+        ++order;
+    }
+
+    std::string str;
+    str.reserve(size);
+    std::vector<size_t> word(order + 1, 0);
+    size_t length = 1;
+    while (str.size() < size) {
+        if (order % length == 0) {
+            for (size_t position = 1; position <= length && str.size() < size; ++position) {
+                str += alphabet[word[position]];
+            }
+        }
+        for (size_t position = length + 1; position <= order; ++position) {
+            word[position] = word[position - length];
+        }
+        length = order;
+        while (length > 0 && word[length] == alphabet.size() - 1) {
+            --length;
+        }
+        if (length == 0) {
+            break;
+        }
+        ++word[length];
+    }
+    return str;
+}
+
+// Prefix function and Z-function of str, for routines whose input is one of these arrays.
+inline std::vector<uint32_t> GeneratePrefixArray(const std::string& str) {
+    std::vector<uint32_t> prefix(str.size(), 0);
+    for (size_t position = 1; position < str.size(); ++position) {
+        uint32_t current_len = prefix[position - 1];
+        while (current_len > 0 && str[current_len] != str[position]) {
+            current_len = prefix[current_len - 1];
+        }
+        prefix[position] = current_len + (str[current_len] == str[position] ? 1 : 0);
+    }
+    return prefix;
+}
+
+inline std::vector<uint32_t> GenerateZArray(const std::string& str) {
+    std::vector<uint32_t> z_block(str.size(), 0);
+    if (!str.empty()) {
+        z_block[0] = str.size();
+    }
+    size_t left = 0;
+    size_t right = 0;
+    for (size_t position = 1; position < str.size(); ++position) {
+        if (position < right) {
+            z_block[position] = std::min<size_t>(right - position, z_block[position - left]);
+        }
+        while (position + z_block[position] < str.size() &&
+               str[z_block[position]] == str[position + z_block[position]]) {
+            ++z_block[position];
+        }
+        if (position + z_block[position] > right) {
+            left = position;
+            right = position + z_block[position];
+        }
+    }
+    return z_block;
+}
+
+// Cuts str into overlapping words of 2 to 16 symbols, one every stride symbols.
+inline std::vector<std::string> GenerateWords(const std::string& str, const size_t& stride) {
+    std::vector<std::string> words;
+    for (size_t position = 0; position + 16 <= str.size(); position += stride) {
+        words.push_back(str.substr(position, 2 + position % 15));
+    }
+    return words;
+}
+
+// Maps letters onto the first alphabet_size digits, for the routines that work on numbers.
+inline std::string ConvertToDigits(std::string str, const uint32_t& alphabet_size) {
+    for (auto& symbol : str) {
+        symbol = static_cast<char>('0' + (symbol - 'a') % alphabet_size);
+    }
+    return str;
+}
+
+struct BenchmarkInput {
+    std::string name;
+    std::function<std::string(const size_t&)> generate;
+};
+
+// Uniform random over the whole alphabet, a single letter, and the Fibonacci, Thue-Morse and
+// de Bruijn words over its first letters.
+inline std::vector<BenchmarkInput> GetBenchmarkInputs(const std::string& alphabet) {
+    char first = alphabet[0];
+    char second = alphabet.size() > 1 ? alphabet[1] : alphabet[0];
+    return {
+        {"random", [alphabet](const size_t& size) { return GenerateRandomString(size, alphabet, size); }},
+        {"one_letter", [first](const size_t& size) { return std::string(size, first); }},
+        {"fibonacci", [first, second](const size_t& size) { return GenerateFibonacciString(size, first, second); }},
+        {"thue_morse", [first, second](const size_t& size) { return GenerateThueMorseString(size, first, second); }},
+        {"de_bruijn", [alphabet](const size_t& size) { return GenerateDeBruijnString(size, alphabet); }},
+    };
+}
+
+// Keeps a result alive so the optimizer cannot drop the loop that produced it.
+inline void DoNotOptimize(const uint64_t& value) {
+    asm volatile("" : : "r"(value) : "memory");
+}
+
+template <class Function>
+double MeasureNanoseconds(Function function) {
+    auto begin = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+inline void ReportBenchmark(const std::string& name, const std::string& input, const size_t& size,
+                            const double& nanoseconds) {
+    std::cout << std::left << std::setw(32) << name << std::setw(12) << input << std::right << std::setw(12) << size
+              << std::fixed << std::setprecision(3) << std::setw(12) << nanoseconds / static_cast<double>(size)
+              << " ns/char" << std::endl;
+}
+
+inline void ReportRate(const std::string& name, const std::string& input, const size_t& count,
+                       const double& nanoseconds, const std::string& unit) {
+    std::cout << std::left << std::setw(32) << name << std::setw(12) << input << std::right << std::setw(12) << count
+              << std::fixed << std::setprecision(0) << std::setw(16) << static_cast<double>(count) * 1e9 / nanoseconds
+              << ' ' << unit << "/s" << std::endl;
+}
+
+// Least-squares slope of log(time) over log(size): 1 for linear routines, 2 for quadratic ones.
+inline double GetScalingExponent(const std::vector<size_t>& sizes, const std::vector<double>& nanoseconds) {
+    std::vector<double> log_size;
+    std::vector<double> log_time;
+    for (size_t iteration = 0; iteration < sizes.size(); ++iteration) {
+        if (sizes[iteration] >= kBenchmarkExponentMinSize || sizes.size() < 3) {
+            log_size.push_back(std::log(static_cast<double>(sizes[iteration])));
+            log_time.push_back(std::log(nanoseconds[iteration]));
+        }
+    }
+    if (log_size.size() < 2) {
+        return NAN;
+    }
+
+    double mean_size = 0;
+    double mean_time = 0;
+    for (size_t iteration = 0; iteration < log_size.size(); ++iteration) {
+        mean_size += log_size[iteration] / log_size.size();
+        mean_time += log_time[iteration] / log_time.size();
+    }
+    double covariance = 0;
+    double variance = 0;
+    for (size_t iteration = 0; iteration < log_size.size(); ++iteration) {
+        covariance += (log_size[iteration] - mean_size) * (log_time[iteration] - mean_time);
+        variance += (log_size[iteration] - mean_size) * (log_size[iteration] - mean_size);
+    }
+    return covariance / variance;
+}
+
+inline long GetPeakKilobytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// A forked child starts with every page of its parent resident, and its peak RSS may start from the
+// parent's peak as well. Called right after fork, this resets the peak to the current RSS where Linux
+// allows it (/proc/self/clear_refs) and returns it, so that GetPeakKilobytes() minus the result is the
+// memory the child took on top of what it inherited.
+inline long ResetPeakKilobytes() {
+    int descriptor = open("/proc/self/clear_refs", O_WRONLY);
+    if (descriptor >= 0) {
+        bool is_reset = write(descriptor, "5", 1) == 1;
+        static_cast<void>(is_reset);
+        close(descriptor);
+    }
+    return GetPeakKilobytes();
+}
+
+// Runs run(prepare(str)) on every benchmark input at sizes 10^3, 10^4, ... up to max_size (and up to
+// the BENCHMARK_MAX_SIZE environment variable), and reports ns/char, peak RSS and the scaling
+// exponent. Every measurement runs in a forked child with stdout sent to /dev/null, so routines that
+// print do not flood the report and an input that runs out of memory only ends its own series; peak
+// RSS counts only what the child took on top of the pages it inherited, see ResetPeakKilobytes. prepare
+// is not timed; run returns a
+// checksum that keeps its work observable. A series stops growing once the next run is projected to take
+// over a minute, assuming ns/char keeps growing the way it did over the last step: linear routines reach
+// 10^7 even at microseconds per char, while quadratic ones stop early.
+template <class Prepare, class Run>
+void RunScalingBenchmark(const std::string& name, const std::string& alphabet, size_t max_size, Prepare prepare,
+                         Run run) {
+    if (const char* limit = std::getenv("BENCHMARK_MAX_SIZE")) {
+        max_size = std::min<size_t>(max_size, std::strtoull(limit, nullptr, 10));
+    }
+    max_size = std::min(max_size, kBenchmarkMaxSize);
+    if (max_size < kBenchmarkMinSize) {
+        return;
+    }
+
+    for (auto& input : GetBenchmarkInputs(alphabet)) {
+        std::vector<size_t> sizes;
+        std::vector<double> times;
+        for (size_t size = kBenchmarkMinSize; size <= max_size; size *= 10) {
+            int channel[2];
+            if (pipe(channel) != 0) {
+                return;
+            }
+            std::cout.flush();
+            pid_t child = fork();
+            if (child == 0) {
+                close(channel[0]);
+                long kilobytes_at_fork = ResetPeakKilobytes();
+                if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+                    _exit(1);
+                }
+                auto prepared = prepare(input.generate(size));
+                uint64_t checksum = 0;
+                double result[2] = {};
+                result[0] = MeasureNanoseconds([&]() { checksum = run(prepared); });
+                DoNotOptimize(checksum);
+                result[1] = GetPeakKilobytes() - kilobytes_at_fork;
+                bool is_written = write(channel[1], result, sizeof(result)) == sizeof(result);
+                _exit(is_written ? 0 : 1);
+            }
+            close(channel[1]);
+            double result[2] = {};
+            bool is_read = read(channel[0], result, sizeof(result)) == sizeof(result);
+            close(channel[0]);
+            double nanoseconds = result[0];
+            long peak_kilobytes = static_cast<long>(result[1]);
+
+            int status = 0;
+            waitpid(child, &status, 0);
+            if (!is_read || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cout << std::left << std::setw(32) << name << std::setw(12) << input.name << std::right
+                          << std::setw(12) << size << "  failed" << std::endl;
+                break;
+            }
+
+            std::cout << std::left << std::setw(32) << name << std::setw(12) << input.name << std::right
+                      << std::setw(12) << size << std::fixed << std::setprecision(3) << std::setw(12)
+                      << nanoseconds / static_cast<double>(size) << " ns/char" << std::setw(10)
+                      << peak_kilobytes / 1024 << " MB peak" << std::endl;
+            double growth = times.empty() ? 1 : std::max(1.0, nanoseconds / times.back() / 10);
+            sizes.push_back(size);
+            times.push_back(nanoseconds);
+            if (10 * growth * nanoseconds > kBenchmarkMaxProjectedNanoseconds) {
+                break;
+            }
+        }
+        std::cout << std::left << std::setw(32) << name << std::setw(12) << input.name << std::right
+                  << "    exponent " << std::fixed << std::setprecision(2) << GetScalingExponent(sizes, times)
+                  << std::endl;
+    }
+}
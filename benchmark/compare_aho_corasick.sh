@@ -0,0 +1,71 @@
+#!/bin/sh
+# Runs the head-to-head comparison of the three Aho-Corasick layouts (Q_map, Q_ptr, Q_vector) on the
+# same texts and pattern sets, and fails if any two layouts disagree on the occurrences they found or if
+# a layout failed or skipped a pattern set. BENCHMARK_MAX_PATTERNS caps the largest pattern set, e.g. on
+# machines that cannot hold the pointer trie for a million patterns.
+set -e
+
+cd "$(dirname "$0")/.."
+mkdir -p _benchmark_build
+
+for name in Q_map Q_ptr Q_vector; do
+    if ! ${CXX:-g++} -std=c++17 -O2 -DBENCHMARK -pthread -o "_benchmark_build/$name" "$name/main.cpp"; then
+        echo "failed to build $name" >&2
+        exit 1
+    fi
+done
+
+# Each layout writes to its own file so that its exit status is not lost in a pipe.
+: > _benchmark_build/aho_corasick.txt
+for name in Q_map Q_ptr Q_vector; do
+    if ! BENCHMARK_MAX_SIZE=0 "_benchmark_build/$name" > "_benchmark_build/$name.txt"; then
+        cat "_benchmark_build/$name.txt"
+        echo "$name failed" >&2
+        exit 1
+    fi
+    cat "_benchmark_build/$name.txt"
+    cat "_benchmark_build/$name.txt" >> _benchmark_build/aho_corasick.txt
+done
+
+# Lines are "aho_corasick/<layout> <input> <patterns> ... <checksum>", or end in "failed" when the child
+# died; a failed run skips the larger pattern sets of its input. Every layout has to report a checksum for
+# every (input, patterns) that any layout reached, and all of those checksums have to agree.
+awk '$1 ~ /^aho_corasick\// {
+    key = $2 " " $3
+    if (!(key in keys)) {
+        keys[key] = 1
+        key_order[++key_count] = key
+    }
+    if (!($1 in layouts)) {
+        layouts[$1] = 1
+        layout_order[++layout_count] = $1
+    }
+    if ($NF == "failed") {
+        print $1 " failed on " key
+        is_mismatch = 1
+        next
+    }
+    seen[$1 SUBSEP key] = 1
+    if (key in checksum && checksum[key] != $NF) {
+        print "checksum mismatch on " key ": " layout[key] " and " $1
+        is_mismatch = 1
+    }
+    checksum[key] = $NF
+    layout[key] = $1
+} END {
+    for (key_index = 1; key_index <= key_count; ++key_index) {
+        for (layout_index = 1; layout_index <= layout_count; ++layout_index) {
+            name = layout_order[layout_index]
+            key = key_order[key_index]
+            if (!((name SUBSEP key) in seen)) {
+                print name " has no checksum on " key
+                is_mismatch = 1
+            }
+        }
+    }
+    if (layout_count == 0) {
+        print "no aho_corasick results"
+        is_mismatch = 1
+    }
+    exit is_mismatch
+}' _benchmark_build/aho_corasick.txt
@@ -0,0 +1,61 @@
+#pragma once
+
+// Named event counters for the hot loops. Built with -DCOUNTERS, every counter is a static uint64_t
+// bound to its name on first use, and all of them are written to stderr as one JSON object when the
+// program exits; stdout keeps only the answer. Without the flag the macros expand to an unevaluated
+// sizeof, so the instrumented loops compile exactly as before.
+
+#ifdef COUNTERS
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+
+class CounterRegistry {
+private:
+    std::map<std::string, uint64_t> value_of_counter_;
+
+public:
+    static CounterRegistry& Get() {
+        static CounterRegistry registry;
+        return registry;
+    }
+
+    uint64_t& GetCounter(const std::string& name) {
+        return value_of_counter_[name];
+    }
+
+    ~CounterRegistry() {
+        std::fprintf(stderr, "{");
+        const char* separator = "";
+        for (auto& [name, value] : value_of_counter_) {
+            std::fprintf(stderr, "%s\n  \"%s\": %llu", separator, name.c_str(), static_cast<unsigned long long>(value));
+            separator = ",";
+        }
+        std::fprintf(stderr, "\n}\n");
+    }
+};
+
+#define COUNTER_ADD(name, value)                                                         \
+    do {                                                                                 \
+        static uint64_t& counter_at_this_line = CounterRegistry::Get().GetCounter(name); \
+        counter_at_this_line += (value);                                                 \
+    } while (false)
+
+#define COUNTER_MAX(name, value)                                                         \
+    do {                                                                                 \
+        static uint64_t& counter_at_this_line = CounterRegistry::Get().GetCounter(name); \
+        if (counter_at_this_line < static_cast<uint64_t>(value)) {                       \
+            counter_at_this_line = (value);                                              \
+        }                                                                                \
+    } while (false)
+
+#else
+
+#define COUNTER_ADD(name, value) static_cast<void>(sizeof(value))
+#define COUNTER_MAX(name, value) static_cast<void>(sizeof(value))
+
+#endif
+
+#define COUNTER_INCREMENT(name) COUNTER_ADD(name, 1)
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Builds every solution with its scaling benchmark and runs them one by one.
+# Usage: benchmark/run.sh [DIR...]; BENCHMARK_MAX_SIZE caps the largest input.
+set -e
+
+cd "$(dirname "$0")/.."
+mkdir -p _benchmark_build
+
+if [ "$#" -eq 0 ]; then
+    set -- */main.cpp
+else
+    for dir in "$@"; do
+        shift
+        set -- "$@" "${dir%/}/main.cpp"
+    done
+fi
+
+for source in "$@"; do
+    name=$(dirname "$source")
+    ${CXX:-g++} -std=c++17 -O2 -DBENCHMARK -pthread -o "_benchmark_build/$name" "$source"
+    echo "== $name"
+    "_benchmark_build/$name"
+done
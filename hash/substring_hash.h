@@ -0,0 +1,143 @@
+#pragma once
+
+// Polynomial hashing modulo the Mersenne prime 2^61 - 1, shared by the solutions that compare
+// substrings by fingerprint (C's benchmark, H and K) so the modular arithmetic lives in one place.
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+const uint64_t kHashModulo = (1ULL << 61) - 1;
+const uint64_t kHashBase = 1000003;
+
+inline uint64_t MultiplyModulo(const uint64_t& left, const uint64_t& right) {
+    auto product = static_cast<unsigned __int128>(left) * right;
+    uint64_t result = static_cast<uint64_t>(product & kHashModulo) + static_cast<uint64_t>(product >> 61);
+    return result >= kHashModulo ? result - kHashModulo : result;
+}
+
+inline uint64_t AddModulo(const uint64_t& left, const uint64_t& right) {
+    uint64_t result = left + right;
+    return result >= kHashModulo ? result - kHashModulo : result;
+}
+
+// Polynomial hash modulo the Mersenne prime 2^61 - 1 with O(1) hashes of arbitrary substrings.
+class PolynomialHash {
+private:
+    std::vector<uint64_t> prefix_hash_;
+    std::vector<uint64_t> power_;
+
+public:
+    explicit PolynomialHash(const std::string& str) {
+        prefix_hash_.resize(str.length() + 1, 0);
+        power_.resize(str.length() + 1, 1);
+        for (uint32_t position = 0; position < str.length(); ++position) {
+            uint64_t symbol = static_cast<unsigned char>(str[position]) + 1;
+            prefix_hash_[position + 1] = AddModulo(MultiplyModulo(prefix_hash_[position], kHashBase), symbol);
+            power_[position + 1] = MultiplyModulo(power_[position], kHashBase);
+        }
+    }
+
+    uint64_t GetHash(const uint32_t& begin, const uint32_t& length) const {
+        uint64_t shifted = MultiplyModulo(prefix_hash_[begin], power_[length]);
+        return AddModulo(prefix_hash_[begin + length], kHashModulo - shifted);
+    }
+
+    uint64_t GetPower(const uint32_t& length) const {
+        return power_[length];
+    }
+};
+
+// Answers substring questions about one fixed text: equality of two substrings in O(1), and whether a
+// pattern occurs, and how often, in O(|pattern|) once the windows of that length have been hashed, which
+// takes O(|text|) on the first query of each length. Equal hashes are trusted, so answers are correct
+// with high probability.
+class SubstringHashIndex {
+private:
+    PolynomialHash text_hash_;
+    uint32_t text_length_ = 0;
+
+    std::unordered_map<uint32_t, std::unordered_map<uint64_t, uint32_t>> count_of_window_;
+
+public:
+    explicit SubstringHashIndex(const std::string& text) : text_hash_(text) {
+        text_length_ = text.length();
+    }
+
+    static uint64_t GetHashOfString(const std::string& str) {
+        uint64_t hash = 0;
+        for (auto& symbol : str) {
+            hash = AddModulo(MultiplyModulo(hash, kHashBase), static_cast<unsigned char>(symbol) + 1);
+        }
+        return hash;
+    }
+
+    uint32_t GetLength() const {
+        return text_length_;
+    }
+
+    uint64_t GetHash(const uint32_t& begin, const uint32_t& length) const {
+        return text_hash_.GetHash(begin, length);
+    }
+
+    bool AreSubstringsEqual(const uint32_t& first_begin, const uint32_t& second_begin, const uint32_t& length) const {
+        return GetHash(first_begin, length) == GetHash(second_begin, length);
+    }
+
+    const std::unordered_map<uint64_t, uint32_t>& GetWindows(const uint32_t& length) {
+        auto it = count_of_window_.find(length);
+        if (it != count_of_window_.end()) {
+            return it->second;
+        }
+        auto& windows = count_of_window_[length];
+        for (uint32_t begin = 0; begin + length <= text_length_; ++begin) {
+            ++windows[GetHash(begin, length)];
+        }
+        return windows;
+    }
+
+    uint32_t Count(const std::string& str) {
+        if (str.length() > text_length_) {
+            return 0;
+        }
+        auto& windows = GetWindows(str.length());
+        auto it = windows.find(GetHashOfString(str));
+        return it == windows.end() ? 0 : it->second;
+    }
+
+    bool Contains(const std::string& str) {
+        return Count(str) > 0;
+    }
+
+    // Batch mode for many patterns, typically of one length: each length is checked in a single pass over
+    // the text against a set of pattern hashes, so no window table is kept.
+    std::vector<uint32_t> CountBatch(const std::vector<std::string>& patterns) const {
+        std::unordered_map<uint32_t, std::unordered_map<uint64_t, uint32_t>> count_of_pattern;
+        std::vector<uint64_t> pattern_hash(patterns.size());
+        for (uint32_t iteration = 0; iteration < patterns.size(); ++iteration) {
+            pattern_hash[iteration] = GetHashOfString(patterns[iteration]);
+            if (patterns[iteration].length() <= text_length_) {
+                count_of_pattern[patterns[iteration].length()][pattern_hash[iteration]] = 0;
+            }
+        }
+
+        for (auto& [length, count_of_hash] : count_of_pattern) {
+            for (uint32_t begin = 0; begin + length <= text_length_; ++begin) {
+                auto it = count_of_hash.find(GetHash(begin, length));
+                if (it != count_of_hash.end()) {
+                    ++it->second;
+                }
+            }
+        }
+
+        std::vector<uint32_t> count_of_entry(patterns.size(), 0);
+        for (uint32_t iteration = 0; iteration < patterns.size(); ++iteration) {
+            auto group = count_of_pattern.find(patterns[iteration].length());
+            if (group != count_of_pattern.end()) {
+                count_of_entry[iteration] = group->second[pattern_hash[iteration]];
+            }
+        }
+        return count_of_entry;
+    }
+};
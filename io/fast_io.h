@@ -0,0 +1,271 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+const size_t kInputBufferSize = 1 << 20;
+const size_t kOutputBufferSize = 1 << 22;
+const size_t kMaxIntegerLength = 24;
+
+// Integers other than bool are read and written as decimal numbers.
+template <class IntegerT>
+using IfIntegerT = std::enable_if_t<std::is_integral_v<IntegerT> && !std::is_same_v<IntegerT, bool>, int>;
+
+// Whitespace-separated tokens and integers from a file descriptor, stdin by default. A regular file is
+// mapped into memory and tokens point straight into the mapping; a pipe or a terminal is read with
+// large read() calls into a buffer that is compacted on refill, so a token is always contiguous.
+class FastReader {
+private:
+    int descriptor_ = STDIN_FILENO;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    std::vector<char> buffer_;
+
+    const char* data_ = nullptr;
+    size_t position_ = 0;
+    size_t size_ = 0;
+    bool is_end_of_input_ = false;
+
+    static bool IsSpace(const char& symbol) {
+        return static_cast<unsigned char>(symbol) <= ' ';
+    }
+
+    // Moves the unread bytes to the front of the buffer and appends what the descriptor has, growing
+    // the buffer when a single token fills it. Returns false once nothing more can be read.
+    bool Refill() {
+        if (mapping_ != nullptr || is_end_of_input_) {
+            return false;
+        }
+        size_t unread = size_ - position_;
+        std::memmove(buffer_.data(), buffer_.data() + position_, unread);
+        if (unread == buffer_.size()) {
+            buffer_.resize(2 * buffer_.size());
+        }
+
+        ssize_t count = 0;
+        do {
+            count = read(descriptor_, buffer_.data() + unread, buffer_.size() - unread);
+        } while (count < 0 && errno == EINTR);
+        if (count <= 0) {
+            is_end_of_input_ = true;
+            count = 0;
+        }
+
+        data_ = buffer_.data();
+        position_ = 0;
+        size_ = unread + count;
+        return count > 0;
+    }
+
+    void SkipSpaces() {
+        while (true) {
+            while (position_ < size_ && IsSpace(data_[position_])) {
+                ++position_;
+            }
+            if (position_ < size_ || !Refill()) {
+                return;
+            }
+        }
+    }
+
+public:
+    explicit FastReader(const int& descriptor = STDIN_FILENO) : descriptor_(descriptor) {
+        struct stat status {};
+        if (fstat(descriptor_, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+            void* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor_, 0);
+            if (mapping != MAP_FAILED) {
+                madvise(mapping, status.st_size, MADV_SEQUENTIAL);
+                mapping_ = mapping;
+                mapping_size_ = status.st_size;
+                data_ = static_cast<const char*>(mapping);
+                size_ = mapping_size_;
+                off_t offset = lseek(descriptor_, 0, SEEK_CUR);
+                position_ = offset > 0 ? std::min<size_t>(offset, size_) : 0;
+                return;
+            }
+        }
+        buffer_.resize(kInputBufferSize);
+        data_ = buffer_.data();
+    }
+
+    FastReader(const FastReader&) = delete;
+    FastReader& operator=(const FastReader&) = delete;
+
+    ~FastReader() {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapping_size_);
+        }
+    }
+
+    // The next token, or an empty view at the end of input. The view stays valid until the next read.
+    std::string_view ReadToken() {
+        SkipSpaces();
+        size_t length = 0;
+        while (true) {
+            while (position_ + length < size_ && !IsSpace(data_[position_ + length])) {
+                ++length;
+            }
+            if (position_ + length < size_ || !Refill()) {
+                break;
+            }
+        }
+        std::string_view token(data_ + position_, length);
+        position_ += length;
+        return token;
+    }
+
+    // Passes the next token to callback as a run of string_views, one per buffer refill, so a token
+    // longer than memory can be streamed from a pipe without growing the buffer. A mapped file gives
+    // the whole token in one view. Returns the length of the token.
+    template <class Callback>
+    size_t ForEachChunkOfToken(Callback callback) {
+        SkipSpaces();
+        size_t token_length = 0;
+        while (true) {
+            size_t length = 0;
+            while (position_ + length < size_ && !IsSpace(data_[position_ + length])) {
+                ++length;
+            }
+            if (length > 0) {
+                callback(std::string_view(data_ + position_, length));
+            }
+            position_ += length;
+            token_length += length;
+            if (position_ < size_ || !Refill()) {
+                break;
+            }
+        }
+        return token_length;
+    }
+
+    // Tokens of a mapped file point into the mapping, so they stay valid for the life of the reader.
+    bool IsMapped() const {
+        return mapping_ != nullptr;
+    }
+
+    // Bytes of a mapped file not read yet, which bounds the total length of the remaining tokens. A pipe
+    // has no known length, so it gives 0.
+    size_t GetUnreadMappedSize() const {
+        return mapping_ != nullptr ? size_ - position_ : 0;
+    }
+
+    // Decimal integer with an optional minus sign; 0 at the end of input.
+    template <class IntegerT>
+    IntegerT ReadInteger() {
+        auto token = ReadToken();
+        bool is_negative = !token.empty() && token[0] == '-';
+        IntegerT value = 0;
+        for (size_t position = is_negative ? 1 : 0; position < token.size(); ++position) {
+            value = value * 10 + static_cast<IntegerT>(token[position] - '0');
+        }
+        return is_negative ? static_cast<IntegerT>(0 - value) : value;
+    }
+
+    FastReader& operator>>(std::string& str) {
+        str.assign(ReadToken());
+        return *this;
+    }
+
+    template <class IntegerT, IfIntegerT<IntegerT> = 0>
+    FastReader& operator>>(IntegerT& value) {
+        value = ReadInteger<IntegerT>();
+        return *this;
+    }
+};
+
+// Collects the whole output in one large buffer and writes it when the buffer fills up or the writer is
+// destroyed, so there is no flush per line. Integers are formatted by hand.
+class FastWriter {
+private:
+    int descriptor_ = STDOUT_FILENO;
+    std::vector<char> buffer_;
+    size_t size_ = 0;
+
+    void WriteAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t count = write(descriptor_, data, size);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return;
+            }
+            data += count;
+            size -= count;
+        }
+    }
+
+public:
+    explicit FastWriter(const int& descriptor = STDOUT_FILENO) : descriptor_(descriptor) {
+        buffer_.resize(kOutputBufferSize);
+    }
+
+    FastWriter(const FastWriter&) = delete;
+    FastWriter& operator=(const FastWriter&) = delete;
+
+    ~FastWriter() {
+        Flush();
+    }
+
+    void Flush() {
+        WriteAll(buffer_.data(), size_);
+        size_ = 0;
+    }
+
+    FastWriter& operator<<(const char& symbol) {
+        if (size_ == buffer_.size()) {
+            Flush();
+        }
+        buffer_[size_++] = symbol;
+        return *this;
+    }
+
+    FastWriter& operator<<(std::string_view str) {
+        if (size_ + str.size() > buffer_.size()) {
+            Flush();
+        }
+        if (str.size() > buffer_.size()) {
+            WriteAll(str.data(), str.size());
+            return *this;
+        }
+        std::memcpy(buffer_.data() + size_, str.data(), str.size());
+        size_ += str.size();
+        return *this;
+    }
+
+    template <class IntegerT, IfIntegerT<IntegerT> = 0>
+    FastWriter& operator<<(const IntegerT& value) {
+        if (size_ + kMaxIntegerLength > buffer_.size()) {
+            Flush();
+        }
+        std::make_unsigned_t<IntegerT> magnitude = value;
+        if constexpr (std::is_signed_v<IntegerT>) {
+            if (value < 0) {
+                buffer_[size_++] = '-';
+                magnitude = 0 - magnitude;
+            }
+        }
+
+        char digits[kMaxIntegerLength];
+        size_t length = 0;
+        do {
+            digits[length++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude > 0);
+        while (length > 0) {
+            buffer_[size_++] = digits[--length];
+        }
+        return *this;
+    }
+};
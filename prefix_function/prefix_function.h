@@ -0,0 +1,99 @@
+#pragma once
+
+// The prefix-function kernel and the matcher built on it, shared by C and K so both ask the same
+// questions (ForEach, Contains, Count) of one implementation.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../benchmark/counters.h"
+
+inline std::vector<uint32_t> PrefixFunction(const std::string& str) {
+    COUNTER_ADD("prefix_function.symbols", str.size());
+    std::vector<uint32_t> prefix(str.length(), 0);
+    for (uint32_t position = 1; position < str.length(); ++position) {
+        uint32_t current_len = prefix[position - 1];
+        while (current_len > 0) {
+            if (str[current_len] == str[position]) {
+                break;
+            }
+            COUNTER_INCREMENT("prefix_function.failure_steps");
+            current_len = prefix[current_len - 1];
+        }
+        if (str[position] == str[current_len]) {
+            ++current_len;
+        }
+        prefix[position] = current_len;
+    }
+    return prefix;
+}
+
+// Keeps only the prefix function of the pattern; the match state lives with the caller, so several
+// texts can be walked through the same pattern at once.
+class PrefixFunctionMatcher {
+private:
+    std::string str_;
+    std::vector<uint32_t> prefix_;
+
+public:
+    explicit PrefixFunctionMatcher(const std::string& str) {
+        str_ = str;
+        prefix_ = PrefixFunction(str);
+    }
+
+    uint32_t Step(uint32_t current_len, const char& symbol) const {
+        while (current_len > 0) {
+            if (current_len < str_.length() && str_[current_len] == symbol) {
+                break;
+            }
+            current_len = prefix_[current_len - 1];
+        }
+        if (current_len < str_.length() && str_[current_len] == symbol) {
+            ++current_len;
+        }
+        return current_len;
+    }
+
+    uint32_t GetLength() const {
+        return str_.length();
+    }
+
+    const std::vector<uint32_t>& GetPrefix() const {
+        return prefix_;
+    }
+
+    // Calls callback(entry) for every entry of the pattern in text, in order; the scan stops as soon
+    // as callback returns false.
+    template <class Callback>
+    void ForEach(const std::string& text, Callback callback) const {
+        if (str_.empty() && !callback(0)) {
+            return;
+        }
+        uint32_t current_len = 0;
+        for (uint32_t position = 0; position < text.length(); ++position) {
+            current_len = Step(current_len, text[position]);
+            if (current_len == str_.length() && !callback(position + 1 - str_.length())) {
+                return;
+            }
+        }
+    }
+
+    bool Contains(const std::string& text) const {
+        bool is_found = false;
+        ForEach(text, [&is_found](const uint32_t&) {
+            is_found = true;
+            return false;
+        });
+        return is_found;
+    }
+
+    uint32_t Count(const std::string& text) const {
+        uint32_t count_of_entry = 0;
+        ForEach(text, [&count_of_entry](const uint32_t&) {
+            ++count_of_entry;
+            return true;
+        });
+        return count_of_entry;
+    }
+};